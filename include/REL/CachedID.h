@@ -0,0 +1,63 @@
+#pragma once
+
+// Resolved-address cache for REL::ID and REL::RelocationID, shared with the
+// benchmarks. Only the standard library is used so they build off Windows.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace REL
+{
+	namespace detail
+	{
+		class ModuleBase;
+
+		// Caches the absolute address of an ID after the first resolution so
+		// later reads skip the singleton, runtime index and IDDB search.
+		// Meant for static (ideally constinit) storage; resolving the same ID
+		// from several threads at once is benign.
+		template <class T>
+		class CachedIDImpl
+		{
+		public:
+			template <class... Args>
+			explicit constexpr CachedIDImpl(Args... a_args) noexcept :
+				m_id(a_args...)
+			{}
+
+			CachedIDImpl(const CachedIDImpl&) = delete;
+			CachedIDImpl& operator=(const CachedIDImpl&) = delete;
+
+			[[nodiscard]] std::uintptr_t address() const
+			{
+				if (const auto address = m_address.load(std::memory_order_relaxed))
+					return address;
+
+				return resolve();
+			}
+
+			[[nodiscard]] std::uint64_t id() const noexcept { return m_id.id(); }
+
+			// `M` only defers the module lookup until REL/Module.h is included
+			template <class M = ModuleBase>
+			[[nodiscard]] std::size_t offset() const
+			{
+				return address() - M::GetSingleton()->base();
+			}
+
+			[[nodiscard]] constexpr const T& get() const noexcept { return m_id; }
+
+		private:
+			std::uintptr_t resolve() const
+			{
+				const auto address = m_id.address();
+				m_address.store(address, std::memory_order_relaxed);
+				return address;
+			}
+
+			T                                   m_id;
+			mutable std::atomic<std::uintptr_t> m_address{ 0 };
+		};
+	}
+}
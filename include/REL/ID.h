@@ -2,9 +2,14 @@
 
 #include "REX/BASE.h"
 
+#include "REL/CachedID.h"
 #include "REL/IDDB.h"
 #include "REL/Module.h"
 
+#ifdef REL_AOT_OFFSETS
+#	include REL_AOT_OFFSETS
+#endif
+
 /**
  * @file ID.h
  * @brief Multi-Runtime RelocationID System for CommonLib-Shared
@@ -41,6 +46,13 @@
  * auto addr = SomeFunction.address();  // VR will use 12345 automatically
  * ```
  * 
+ * ## Resolve-Once Caching
+ * ```cpp
+ * // First call resolves through IDDB, later calls are a single atomic load
+ * static constinit REL::CachedID<REL::RelocationID> PlayerCharacter_Update{12345, 67890};
+ * auto addr = PlayerCharacter_Update.address();
+ * ```
+ * 
  * # Configuration
  * 
  * Games configure their runtime count via build system:
@@ -66,6 +78,8 @@
  * - Single runtime builds (N=1): Zero overhead, compiles to direct array access
  * - Multi-runtime builds: Single function call overhead for runtime detection
  * - IDDB operations: Fully optimized binary search in shared library
+ * - CachedID: Resolved address stored after first use for hot paths
+ * - REL_AOT_OFFSETS: Offsets baked at build time for one pinned game version
  * - Memory usage: Shared library code reused across all games
  */
 
@@ -98,6 +112,24 @@ namespace REL
 			}
 		}
 
+#ifdef REL_AOT_OFFSETS
+		// Whether the running game is the version REL_AOT_OFFSETS was
+		// generated for; checked once.
+		[[nodiscard]] inline bool aot_active() noexcept
+		{
+			static const bool active = ModuleBase::GetSingleton()->version() == Version{ aot::VERSION };
+			return active;
+		}
+
+		// Baked offset of an ID if the game runs the pinned version
+		[[nodiscard]] inline std::optional<std::uint64_t> aot_offset(const std::uint64_t a_aot) noexcept
+		{
+			if (a_aot && aot_active())
+				return a_aot;
+			return std::nullopt;
+		}
+#endif
+
 		class ID
 		{
 		public:
@@ -126,10 +158,38 @@ namespace REL
 
 			[[nodiscard]] std::size_t offset() const
 			{
+#ifdef REL_AOT_OFFSETS
+				if (const auto offset = aot_offset(aot::offset(m_id)))
+					return *offset;
+#endif
 				const auto iddb = IDDB::GetSingleton();
 				return iddb->offset(m_id);
 			}
 
+			// Like address(), but empty instead of failing for IDs missing
+			// from the loaded database
+			[[nodiscard]] std::optional<std::uintptr_t> try_address() const
+			{
+#ifdef REL_AOT_OFFSETS
+				if (const auto offset = aot_offset(aot::offset(m_id)))
+					return ModuleBase::GetSingleton()->base() + *offset;
+#endif
+				const auto iddb = IDDB::GetSingleton();
+				if (const auto offset = iddb->try_offset(m_id))
+					return ModuleBase::GetSingleton()->base() + *offset;
+				return std::nullopt;
+			}
+
+			[[nodiscard]] bool valid() const
+			{
+#ifdef REL_AOT_OFFSETS
+				if (aot_offset(aot::offset(m_id)))
+					return true;
+#endif
+				const auto iddb = IDDB::GetSingleton();
+				return iddb->contains(m_id);
+			}
+
 		private:
 			std::uint64_t m_id{ 0 };
 		};
@@ -233,8 +293,13 @@ namespace REL
 
 			[[nodiscard]] std::size_t offset() const
 			{
+				const auto resolved = id();
+#ifdef REL_AOT_OFFSETS
+				if (const auto offset = aot_offset(aot::offset(resolved)))
+					return *offset;
+#endif
 				const auto iddb = IDDB::GetSingleton();
-				return iddb->offset(id());
+				return iddb->offset(resolved);
 			}
 
 			// Direct access to raw IDs (before fallback resolution)
@@ -293,4 +358,7 @@ namespace REL
 	// Bring core types into main REL namespace for compatibility
 	using ID = detail::ID;
 	using RelocationID = detail::RelocationIDImpl<detail::DEFAULT_RUNTIME_COUNT>;
+
+	template <class T = RelocationID>
+	using CachedID = detail::CachedIDImpl<T>;
 }
\ No newline at end of file
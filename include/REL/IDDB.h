@@ -2,7 +2,10 @@
 
 #include "REX/BASE.h"
 
+#include "REL/IDDBCodec.h"
+
 #include "REX/REX/MemoryMap.h"
+#include "REX/REX/SharedRegion.h"
 #include "REX/REX/Singleton.h"
 
 namespace REL
@@ -34,34 +37,228 @@ namespace REL
 			V5 = 5
 		};
 
-		struct MAPPING
+		using MAPPING = codec::MAPPING;
+
+		// Load phase timings and lookup counters, collected when built with
+		// commonlib_iddb_stats and left empty otherwise.
+		struct STATS
 		{
-			std::uint64_t id;
-			std::uint64_t offset;
+			enum class Phase : std::uint32_t
+			{
+				Discover,  // locating the database
+				Open,      // opening the source or cache
+				Header,    // parsing the header
+				Decode,    // decoding or parsing the mappings
+				Sort,      // sorting the mappings by ID
+				Validate,  // hashing for the blacklist check
+				Map,       // creating the shared memory map
+			};
+
+			static constexpr std::size_t PHASE_COUNT{ std::to_underlying(Phase::Map) + 1 };
+
+			bool                                                 enabled{ false };
+			std::array<std::chrono::nanoseconds, PHASE_COUNT>    phases{};
+			std::uint64_t                                        lookups{ 0 };
+			std::uint64_t                                        misses{ 0 };
+			std::vector<std::pair<std::uint64_t, std::uint64_t>> top;  // ID and count, most resolved first
 		};
 
 		IDDB();
+		~IDDB();
+
+		// Starts loading the database on a worker thread and returns at once.
+		// The first lookup then only blocks until that load completes. Call it
+		// early from the plugin's load callback, never from DllMain.
+		static void Prefetch();
 
 		std::uint64_t offset(std::uint64_t a_id) const;
 
+		// Look up an ID without failing when the database lacks it, e.g. to
+		// probe for optional features
+		[[nodiscard]] std::optional<std::uint64_t> try_offset(std::uint64_t a_id) const;
+		[[nodiscard]] bool                         contains(std::uint64_t a_id) const;
+
+		// Resolve many IDs in one sweep; every missing ID is reported at once
+		void offsets(std::span<const std::uint64_t> a_ids, std::span<std::uint64_t> a_out) const;
+		void addresses(std::span<const std::uint64_t> a_ids, std::span<std::uintptr_t> a_out) const;
+
+		[[nodiscard]] STATS stats(std::size_t a_top = 10) const;
+
+		// Writes the ID manifest now, e.g. once the game has loaded its data,
+		// instead of relying on static destruction. IDs resolved later are
+		// still written at exit. Does nothing without the manifest option.
+		void flush() const;
+
 	private:
 		class STREAM;
 		class HEADER_V2;
 		class HEADER_V5;
 
+		// Read-only view of the ID-sorted table in either shared layout: wide
+		// MAPPING pairs, or parallel arrays of 32-bit IDs and offsets.
+		class TABLE
+		{
+		public:
+			TABLE() noexcept = default;
+
+			TABLE(std::span<const MAPPING> a_mappings) noexcept :
+				m_mappings(a_mappings.data()),
+				m_size(a_mappings.size())
+			{}
+
+			TABLE(const std::uint32_t* a_ids, const std::uint32_t* a_offsets, std::size_t a_size) noexcept :
+				m_ids(a_ids),
+				m_offsets(a_offsets),
+				m_size(a_size)
+			{}
+
+			[[nodiscard]] bool          empty() const noexcept { return m_size == 0; }
+			[[nodiscard]] std::size_t   size() const noexcept { return m_size; }
+			[[nodiscard]] std::uint64_t id(std::size_t a_pos) const noexcept { return m_mappings ? m_mappings[a_pos].id : m_ids[a_pos]; }
+			[[nodiscard]] std::uint64_t offset(std::size_t a_pos) const noexcept { return m_mappings ? m_mappings[a_pos].offset : m_offsets[a_pos]; }
+
+			// First position in [a_first, a_last) whose ID is not below `a_id`
+			[[nodiscard]] std::size_t lower_bound(std::uint64_t a_id, std::size_t a_first, std::size_t a_last) const noexcept;
+
+		private:
+			const MAPPING*       m_mappings{ nullptr };
+			const std::uint32_t* m_ids{ nullptr };
+			const std::uint32_t* m_offsets{ nullptr };
+			std::size_t          m_size{ 0 };
+		};
+
+		using INDEX = codec::INDEX;
+
+		// Bitmap of the IDs in the table with a running count every 512 IDs,
+		// so both membership and the table position of an ID take O(1).
+		class PRESENCE
+		{
+		public:
+			static constexpr auto npos{ static_cast<std::size_t>(-1) };
+
+			// Collects the IDs of a table of `a_count` unique entries; gives up
+			// if they are too sparse for the bitmap to pay off.
+			void reserve(std::size_t a_count);
+			void set(std::uint64_t a_id);
+			bool finish();
+
+			[[nodiscard]] bool        empty() const noexcept { return m_ranks.empty(); }
+			[[nodiscard]] bool        contains(std::uint64_t a_id) const noexcept;
+			[[nodiscard]] std::size_t find(std::uint64_t a_id) const noexcept;
+
+		private:
+			static constexpr std::size_t WORDS_PER_RANK{ 8 };
+
+			std::vector<std::uint64_t> m_bits;
+			std::vector<std::uint32_t> m_ranks;
+			std::size_t                m_count{ 0 };
+			std::uint64_t              m_limit{ 0 };
+			bool                       m_overflow{ false };
+		};
+
+		// Offsets of the IDs resolved in the previous session, looked up again
+		// on a worker thread at startup and kept in an open-addressed table
+		// that lookups check first.
+		class PROFILE
+		{
+		public:
+			void build(std::span<const MAPPING> a_mappings);
+
+			[[nodiscard]] std::optional<std::uint64_t> find(std::uint64_t a_id) const noexcept;
+
+		private:
+			static constexpr std::uint64_t EMPTY{ std::numeric_limits<std::uint64_t>::max() };
+
+			[[nodiscard]] std::size_t slot(std::uint64_t a_id) const noexcept { return static_cast<std::size_t>((a_id * 0x9E3779B97F4A7C15) >> m_shift); }
+
+			std::vector<MAPPING> m_slots;
+			std::uint32_t        m_shift{ 0 };
+			std::atomic<bool>    m_ready{ false };
+		};
+
+		// V1/V2 delta stream kept undecoded with a restart point every BLOCK
+		// entries, so only the blocks holding requested IDs are ever decoded.
+		class LAZY
+		{
+		public:
+			LAZY() = default;
+			LAZY(const LAZY&) = delete;
+			~LAZY();
+
+			LAZY& operator=(const LAZY&) = delete;
+
+			// Takes the padded stream; fails if it is truncated or its IDs
+			// are not ascending, since blocks can then not be searched. The
+			// IDs are collected into `a_presence` on the way.
+			bool build(std::vector<std::byte> a_data, std::size_t a_count, std::uint64_t a_pointerSize, PRESENCE& a_presence);
+
+			[[nodiscard]] bool               empty() const noexcept { return m_restarts.empty(); }
+			[[nodiscard]] std::size_t        size() const noexcept { return m_count; }
+			[[nodiscard]] const MAPPING&     at(std::size_t a_pos) const { return block(a_pos / BLOCK)[a_pos % BLOCK]; }
+			[[nodiscard]] const MAPPING*     lower_bound(std::uint64_t a_id) const;
+			[[nodiscard]] std::span<MAPPING> materialize() const;
+
+			// Resolves `a_requests`, sorted by ID with each `offset` naming its
+			// slot in `a_out`, in one walk over the restart points and blocks.
+			// Absent IDs get 0 and are appended to `a_missing` once each.
+			void offsets(std::span<const MAPPING> a_requests, std::span<std::uint64_t> a_out, std::vector<std::uint64_t>& a_missing) const;
+
+		private:
+			static constexpr std::size_t BLOCK{ 256 };
+
+			struct RESTART
+			{
+				std::size_t   pos;
+				MAPPING       prev;
+				std::uint64_t firstID;
+			};
+
+			[[nodiscard]] std::size_t    block_size(std::size_t a_block) const noexcept { return std::min(BLOCK, m_count - a_block * BLOCK); }
+			[[nodiscard]] const MAPPING* block(std::size_t a_block) const;
+
+			std::vector<std::byte>                           m_data;
+			std::vector<RESTART>                             m_restarts;
+			std::size_t                                      m_count{ 0 };
+			std::uint64_t                                    m_pointerSize{ 0 };
+			mutable std::unique_ptr<std::atomic<MAPPING*>[]> m_blocks;
+			mutable std::once_flag                           m_materialized;
+			mutable std::vector<MAPPING>                     m_all;
+		};
+
+		void load();
 		void load_v0();
 		void load_v2(STREAM& a_stream);
 		void load_v5(STREAM& a_stream);
-		void load_csv(STREAM& a_stream);
-		void unpack_file(STREAM& a_stream, const HEADER_V2& a_header);
-		void validate_file();
+		void load_csv();
+		bool load_lazy(STREAM& a_stream, const HEADER_V2& a_header);
+		bool                    map_table(std::size_t a_count);
+		REX::SharedRegion::Role claim_table(std::size_t a_count, std::chrono::milliseconds a_timeout);
+		void                    fill_table(std::span<const MAPPING> a_mappings);
+		void                    keep_private(std::vector<MAPPING> a_mappings);
+		bool unpack_file(STREAM& a_stream, const HEADER_V2& a_header, std::span<MAPPING> a_out);
+		bool unpack_buffer(std::span<const std::byte> a_data, const HEADER_V2& a_header, std::span<MAPPING> a_out);
+		bool unpack_stream(STREAM& a_stream, const HEADER_V2& a_header, std::span<MAPPING> a_out);
+		void validate_file(const REX::MemoryMap& a_file);
+		void preload();
+		void write_manifest() const;
+		bool load_cache();
+		void write_cache(std::span<const MAPPING> a_mappings) const;
+
+		static void sort(std::span<MAPPING> a_mappings, std::uint64_t MAPPING::* a_key);
+
+		[[nodiscard]] std::optional<std::uint64_t> lookup(std::uint64_t a_id) const;
 
 	protected:
 		friend class Offset2ID;
 
+		// Either layout of the ID-sorted table; empty for V5
+		[[nodiscard]] TABLE       get_table() const { return m_lazy.empty() ? m_table : TABLE{ m_lazy.materialize() }; }
+		[[nodiscard]] std::size_t get_table_size() const noexcept { return m_lazy.empty() ? m_table.size() : m_lazy.size(); }
+
+		// Dense V5 offsets only; V0/V1/V2/CSV tables are read through get_table(),
+		// as the compact layout holds no MAPPING pairs to return
 		// clang-format off
 		template <class T> std::span<T>      get_id2offset() const noexcept;
-		template <> std::span<MAPPING>       get_id2offset() const noexcept { return m_v0; }
 		template <> std::span<std::uint32_t> get_id2offset() const noexcept { return m_v5; }
 		// clang-format on
 
@@ -72,5 +269,13 @@ namespace REL
 		REX::MemoryMap           m_mmap;
 		std::span<MAPPING>       m_v0;
 		std::span<std::uint32_t> m_v5;
+		TABLE                    m_table;
+		std::vector<MAPPING>     m_private;
+		INDEX                    m_index;
+		PRESENCE                 m_presence;
+		LAZY                     m_lazy;
+		std::filesystem::path    m_manifest;
+		PROFILE                  m_profile;
+		std::jthread             m_preload;
 	};
 }
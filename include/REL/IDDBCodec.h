@@ -0,0 +1,426 @@
+#pragma once
+
+// Address Library encodings and lookup index shared by REL::IDDB and the
+// offline tools. Only the standard library is used so the tools build off
+// Windows.
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <emmintrin.h>
+
+namespace REL::codec
+{
+	struct MAPPING
+	{
+		std::uint64_t id;
+		std::uint64_t offset;
+	};
+
+	// Delta-encoded V1/V2 fields carry a 3-bit type selecting how the next
+	// value is derived from the previous one:
+	//   0: u64,  1: prev + 1,  2: prev + u8,  3: prev - u8,
+	//   4: prev + u16,  5: prev - u16,  6: u16,  7: u32
+	struct DELTA_TYPE
+	{
+		std::uint64_t size;  // operand bytes consumed
+		std::uint64_t mask;  // operand bits kept from an 8-byte load
+		std::uint64_t base;  // all ones if relative to the previous value
+		std::uint64_t sign;  // all ones if the operand is subtracted
+		std::uint64_t bias;  // constant added to the operand
+	};
+
+	// clang-format off
+	inline constexpr std::array<DELTA_TYPE, 8> DELTA_TYPES{ {
+		{ 8, ~0ull,        0,     0,     0 },
+		{ 0, 0,            ~0ull, 0,     1 },
+		{ 1, 0xFF,         ~0ull, 0,     0 },
+		{ 1, 0xFF,         ~0ull, ~0ull, 0 },
+		{ 2, 0xFFFF,       ~0ull, 0,     0 },
+		{ 2, 0xFFFF,       ~0ull, ~0ull, 0 },
+		{ 2, 0xFFFF,       0,     0,     0 },
+		{ 4, 0xFFFFFFFF,   0,     0,     0 },
+	} };
+	// clang-format on
+
+	// Worst case read past the end of the data: a type byte and two full
+	// 8-byte operand loads.
+	inline constexpr std::size_t DELTA_PADDING{ 1 + 2 * sizeof(std::uint64_t) };
+
+	// Decodes a single field without branching on its type; the source
+	// must be readable for 8 bytes past the cursor.
+	inline std::uint64_t decode_delta(const std::byte*& a_cursor, const std::size_t a_type, const std::uint64_t a_prev) noexcept
+	{
+		const auto&   type = DELTA_TYPES[a_type];
+		std::uint64_t raw;
+		std::memcpy(&raw, a_cursor, sizeof(raw));
+		a_cursor += type.size;
+
+		const auto value = (raw & type.mask) + type.bias;
+		return (a_prev & type.base) + ((value ^ type.sign) - type.sign);
+	}
+
+	// Decodes the mapping that follows `a_prev` in a V1/V2 stream; fails on
+	// an unknown ID type.
+	inline bool decode_mapping(const std::byte*& a_cursor, const MAPPING& a_prev, const std::uint64_t a_pointerSize, MAPPING& a_out) noexcept
+	{
+		const auto type = static_cast<std::uint8_t>(*a_cursor++);
+		const auto lo = static_cast<std::uint8_t>(type & 0xF);
+		const auto hi = static_cast<std::uint8_t>(type >> 4);
+		if (lo > 7)
+			return false;
+
+		const auto id = decode_delta(a_cursor, lo, a_prev.id);
+
+		const bool scaled = (hi & 8) != 0;
+		auto       offset = decode_delta(a_cursor, hi & 7, scaled ? a_prev.offset / a_pointerSize : a_prev.offset);
+		if (scaled)
+			offset *= a_pointerSize;
+
+		a_out = { id, offset };
+		return true;
+	}
+
+	enum class DECODE : std::uint32_t
+	{
+		Ordered,    // decoded, IDs ascending
+		Unordered,  // decoded, IDs need sorting
+		BadType,    // unknown ID type
+		Truncated,  // the stream ended early
+	};
+
+	// Decodes `a_out.size()` mappings from a buffered V1/V2 stream. The
+	// buffer must be readable for DELTA_PADDING bytes past `a_data`.
+	inline DECODE decode_buffer(const std::span<const std::byte> a_data, const std::uint64_t a_pointerSize, const std::span<MAPPING> a_out) noexcept
+	{
+		const auto last = a_data.data() + a_data.size();
+
+		auto    cursor = a_data.data();
+		MAPPING prev{ 0, 0 };
+		bool    unordered = false;
+		for (auto& mapping : a_out) {
+			if (!decode_mapping(cursor, prev, a_pointerSize, mapping))
+				return DECODE::BadType;
+			if (cursor > last)
+				return DECODE::Truncated;
+
+			unordered |= mapping.id < prev.id;
+			prev = mapping;
+		}
+
+		return unordered ? DECODE::Unordered : DECODE::Ordered;
+	}
+
+	// Decodes a V1/V2 stream one field at a time from `a_stream`, which
+	// provides `readout<T>()` and reports the end of the stream itself.
+	// Used when the file cannot be buffered.
+	template <class S>
+	DECODE decode_fields(S& a_stream, const std::uint64_t a_pointerSize, const std::span<MAPPING> a_out)
+	{
+		const auto read = [&](const std::uint64_t a_type, const std::uint64_t a_prev) {
+			switch (a_type) {
+				case 0:
+					return a_stream.template readout<std::uint64_t>();
+				case 1:
+					return a_prev + 1;
+				case 2:
+					return a_prev + a_stream.template readout<std::uint8_t>();
+				case 3:
+					return a_prev - a_stream.template readout<std::uint8_t>();
+				case 4:
+					return a_prev + a_stream.template readout<std::uint16_t>();
+				case 5:
+					return a_prev - a_stream.template readout<std::uint16_t>();
+				case 6:
+					return static_cast<std::uint64_t>(a_stream.template readout<std::uint16_t>());
+				default:
+					return static_cast<std::uint64_t>(a_stream.template readout<std::uint32_t>());
+			}
+		};
+
+		MAPPING prev{ 0, 0 };
+		bool    unordered = false;
+		for (auto& mapping : a_out) {
+			const auto type = a_stream.template readout<std::uint8_t>();
+			const auto lo = static_cast<std::uint8_t>(type & 0xF);
+			const auto hi = static_cast<std::uint8_t>(type >> 4);
+			if (lo > 7)
+				return DECODE::BadType;
+
+			const auto id = read(lo, prev.id);
+
+			const bool scaled = (hi & 8) != 0;
+			auto       offset = read(hi & 7, scaled ? prev.offset / a_pointerSize : prev.offset);
+			if (scaled)
+				offset *= a_pointerSize;
+
+			mapping = { id, offset };
+			unordered |= id < prev.id;
+			prev = mapping;
+		}
+
+		return unordered ? DECODE::Unordered : DECODE::Ordered;
+	}
+
+	// Picks the shortest type deriving `a_value` from `a_prev`, returning
+	// it with the operand to store.
+	inline std::pair<std::uint8_t, std::uint64_t> encode_delta(const std::uint64_t a_value, const std::uint64_t a_prev) noexcept
+	{
+		if (a_value == a_prev + 1)
+			return { 1, 0 };
+
+		if (a_value > a_prev) {
+			const auto delta = a_value - a_prev;
+			if (delta <= 0xFF)
+				return { 2, delta };
+			if (delta <= 0xFFFF)
+				return { 4, delta };
+		} else {
+			const auto delta = a_prev - a_value;
+			if (delta <= 0xFF)
+				return { 3, delta };
+			if (delta <= 0xFFFF)
+				return { 5, delta };
+		}
+
+		if (a_value <= 0xFFFF)
+			return { 6, a_value };
+		if (a_value <= 0xFFFFFFFF)
+			return { 7, a_value };
+		return { 0, a_value };
+	}
+
+	// Appends `a_next` to a V1/V2 stream whose last mapping is `a_prev`,
+	// scaling the offset by the pointer size when that is shorter.
+	inline void encode_mapping(std::vector<std::byte>& a_out, const MAPPING& a_prev, const MAPPING& a_next, const std::uint64_t a_pointerSize)
+	{
+		const auto [idType, idOperand] = encode_delta(a_next.id, a_prev.id);
+		auto [offsetType, offsetOperand] = encode_delta(a_next.offset, a_prev.offset);
+
+		bool scaled = false;
+		if (a_pointerSize != 0 && a_next.offset % a_pointerSize == 0) {
+			const auto [type, operand] = encode_delta(a_next.offset / a_pointerSize, a_prev.offset / a_pointerSize);
+			if (DELTA_TYPES[type].size < DELTA_TYPES[offsetType].size) {
+				offsetType = type;
+				offsetOperand = operand;
+				scaled = true;
+			}
+		}
+
+		a_out.push_back(static_cast<std::byte>(idType | (offsetType | (scaled ? 8 : 0)) << 4));
+		for (const auto& [type, operand] : { std::pair{ idType, idOperand }, std::pair{ offsetType, offsetOperand } }) {
+			for (std::uint64_t i = 0; i < DELTA_TYPES[type].size; ++i)
+				a_out.push_back(static_cast<std::byte>(operand >> (i * 8)));
+		}
+	}
+
+	// Splits off the next '\n'-terminated line, mirroring std::getline.
+	inline std::string_view next_line(std::string_view& a_text) noexcept
+	{
+		const auto pos = a_text.find('\n');
+		const auto line = a_text.substr(0, pos);
+		a_text.remove_prefix(pos != std::string_view::npos ? pos + 1 : a_text.size());
+		return line;
+	}
+
+	inline std::string_view trim(std::string_view a_str) noexcept
+	{
+		constexpr std::string_view WHITESPACE{ " \t\r\n" };
+
+		const auto first = a_str.find_first_not_of(WHITESPACE);
+		if (first == std::string_view::npos)
+			return {};
+
+		const auto last = a_str.find_last_not_of(WHITESPACE);
+		return a_str.substr(first, last - first + 1);
+	}
+
+	// Parses a leading decimal, or with `a_hex` also a 0x-prefixed
+	// hexadecimal, integer. Like std::stoull, leading whitespace and a
+	// single `+` are skipped and trailing characters are ignored.
+	inline std::errc parse_integer(std::string_view a_str, std::uint64_t& a_value, const bool a_hex) noexcept
+	{
+		const auto first = a_str.find_first_not_of(" \t\n\v\f\r");
+		a_str.remove_prefix(first == std::string_view::npos ? a_str.size() : first);
+		if (a_str.starts_with('+'))
+			a_str.remove_prefix(1);
+
+		int base = 10;
+		if (a_hex && a_str.size() > 2 && a_str[0] == '0' && (a_str[1] == 'x' || a_str[1] == 'X')) {
+			a_str.remove_prefix(2);
+			base = 16;
+		}
+
+		return std::from_chars(a_str.data(), a_str.data() + a_str.size(), a_value, base).ec;
+	}
+
+	struct CSV_DIAG
+	{
+		enum class Kind
+		{
+			MissingComma,
+			Empty,
+			Invalid,
+			OutOfRange,
+			Duplicate
+		};
+
+		Kind             kind;
+		std::size_t      line;
+		std::string_view text;
+		std::uint64_t    id{ 0 };
+		std::uint64_t    previous{ 0 };
+		std::uint64_t    offset{ 0 };
+	};
+
+	struct CSV_CHUNK
+	{
+		std::vector<MAPPING>     mappings;
+		std::vector<std::size_t> lines;
+		std::vector<CSV_DIAG>    diags;
+		std::size_t              lineCount{ 0 };
+	};
+
+	// Tokenizes `id,offset` lines in place. Line numbers are relative to
+	// the start of the chunk.
+	inline void parse_csv_chunk(std::string_view a_text, CSV_CHUNK& a_chunk)
+	{
+		a_chunk.mappings.reserve(a_text.size() / 16);
+		a_chunk.lines.reserve(a_text.size() / 16);
+
+		for (; !a_text.empty(); a_chunk.lineCount++) {
+			const auto line = next_line(a_text);
+			const auto lineNumber = a_chunk.lineCount;
+			if (line.empty() || line[0] == '#') {
+				continue;  // Skip empty lines and comments
+			}
+			const auto commaPos = line.find(',');
+			if (commaPos == std::string_view::npos) {
+				a_chunk.diags.push_back({ CSV_DIAG::Kind::MissingComma, lineNumber, line });
+				continue;
+			}
+			const auto idStr = trim(line.substr(0, commaPos));
+			const auto offsetStr = trim(line.substr(commaPos + 1));
+			if (idStr.empty() || offsetStr.empty()) {
+				a_chunk.diags.push_back({ CSV_DIAG::Kind::Empty, lineNumber, line });
+				continue;
+			}
+			std::uint64_t id = 0;
+			std::uint64_t offset = 0;
+			auto          ec = parse_integer(idStr, id, false);
+			if (ec == std::errc{})
+				ec = parse_integer(offsetStr, offset, true);
+			if (ec == std::errc::result_out_of_range) {
+				a_chunk.diags.push_back({ CSV_DIAG::Kind::OutOfRange, lineNumber, line });
+			} else if (ec != std::errc{}) {
+				a_chunk.diags.push_back({ CSV_DIAG::Kind::Invalid, lineNumber, line });
+			} else {
+				a_chunk.mappings.push_back({ id, offset });
+				a_chunk.lines.push_back(lineNumber);
+			}
+		}
+	}
+
+	// Static B-tree over the IDs of a sorted table, one cache line of sorted
+	// keys per node, searched with SIMD compares instead of a binary search.
+	class INDEX
+	{
+	public:
+		static constexpr auto npos{ static_cast<std::size_t>(-1) };
+
+		// `T` provides `empty()`, `size()`, `id(pos)` and `offset(pos)`
+		template <class T>
+		void build(const T& a_table)
+		{
+			m_nodes.clear();
+			m_offsets.clear();
+
+			// Keys are stored biased so SSE2's signed compares order them as
+			// unsigned; the all-ones ID is reserved for padding.
+			if (a_table.empty() || a_table.id(a_table.size() - 1) >= std::numeric_limits<std::uint32_t>::max())
+				return;
+
+			const auto size = a_table.size();
+			m_nodes.resize((size + B - 1) / B);
+			m_offsets.resize(m_nodes.size() * B);
+
+			std::size_t next = 0;
+			fill(a_table, 0, next);
+		}
+
+		[[nodiscard]] bool          empty() const noexcept { return m_nodes.empty(); }
+		[[nodiscard]] std::uint64_t id(std::size_t a_pos) const noexcept { return m_nodes[a_pos / B].keys[a_pos % B] ^ BIAS; }
+		[[nodiscard]] std::uint64_t offset(std::size_t a_pos) const noexcept { return m_offsets[a_pos]; }
+
+		[[nodiscard]] std::size_t lower_bound(const std::uint64_t a_id) const noexcept
+		{
+			if (a_id >= std::numeric_limits<std::uint32_t>::max())
+				return npos;
+
+			const auto key = _mm_set1_epi32(static_cast<std::int32_t>(static_cast<std::uint32_t>(a_id) ^ BIAS));
+
+			std::size_t result = npos;
+			for (std::size_t node = 0; node < m_nodes.size();) {
+				const auto keys = reinterpret_cast<const __m128i*>(m_nodes[node].keys);
+				const auto lo = _mm_packs_epi32(_mm_cmpgt_epi32(key, _mm_load_si128(keys + 0)), _mm_cmpgt_epi32(key, _mm_load_si128(keys + 1)));
+				const auto hi = _mm_packs_epi32(_mm_cmpgt_epi32(key, _mm_load_si128(keys + 2)), _mm_cmpgt_epi32(key, _mm_load_si128(keys + 3)));
+				const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(lo, hi)));
+
+				// Number of keys in this node less than the ID
+				const auto i = static_cast<std::size_t>(std::popcount(mask));
+				if (i < B && m_nodes[node].keys[i] != PADDING)
+					result = node * B + i;
+
+				node = child(node, i);
+			}
+
+			return result;
+		}
+
+	private:
+		static constexpr std::size_t   B{ 16 };
+		static constexpr std::uint32_t BIAS{ 0x80000000 };
+		static constexpr std::uint32_t PADDING{ std::numeric_limits<std::uint32_t>::max() ^ BIAS };
+
+		struct alignas(64) NODE
+		{
+			std::uint32_t keys[B];
+		};
+
+		[[nodiscard]] static constexpr std::size_t child(std::size_t a_node, std::size_t a_idx) noexcept { return a_node * (B + 1) + a_idx + 1; }
+
+		// Fills the nodes in (B+1)-ary in-order so each node holds the keys
+		// separating its children; slots left over at the end stay as padding.
+		template <class T>
+		void fill(const T& a_table, const std::size_t a_node, std::size_t& a_next)
+		{
+			if (a_node >= m_nodes.size())
+				return;
+
+			for (std::size_t i = 0; i < B; ++i) {
+				fill(a_table, child(a_node, i), a_next);
+				if (a_next < a_table.size()) {
+					m_nodes[a_node].keys[i] = static_cast<std::uint32_t>(a_table.id(a_next)) ^ BIAS;
+					m_offsets[a_node * B + i] = a_table.offset(a_next);
+					++a_next;
+				} else {
+					m_nodes[a_node].keys[i] = PADDING;
+				}
+			}
+			fill(a_table, child(a_node, B), a_next);
+		}
+
+		std::vector<NODE>          m_nodes;
+		std::vector<std::uint64_t> m_offsets;
+	};
+}
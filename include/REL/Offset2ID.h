@@ -4,6 +4,8 @@
 
 #include "REL/IDDB.h"
 
+#include "REX/REX/MemoryMap.h"
+
 namespace REL
 {
 	class Offset2ID :
@@ -12,29 +14,98 @@ namespace REL
 	public:
 		using value_type = IDDB::MAPPING;
 		using container_type = std::vector<value_type>;
+		using view_type = std::span<const value_type>;
 		using size_type = typename container_type::size_type;
-		using const_iterator = typename container_type::const_iterator;
-		using const_reverse_iterator = typename container_type::const_reverse_iterator;
+		using const_iterator = typename view_type::iterator;
+		using const_reverse_iterator = typename view_type::reverse_iterator;
+
+		struct LOCATION
+		{
+			std::uint64_t id{ 0 };            // ID at or below the offset
+			std::size_t   displacement{ 0 };  // distance from the offset of that ID
+			bool          function{ false };  // whether the ID starts the function holding the offset
+		};
+
+		struct SYMBOL
+		{
+			enum class Status : std::uint32_t
+			{
+				Resolved,       // `location` is valid
+				OutsideModule,  // the address is not in the game module
+				NoID,           // no ID lies at or below the address
+			};
+
+			std::uintptr_t address{ 0 };
+			std::size_t    offset{ 0 };  // from the game module's base, if inside it
+			Status         status{ Status::OutsideModule };
+			LOCATION       location;
+		};
 
 		void                        load_v2();
 		void                        load_v5();
 		[[nodiscard]] std::uint64_t get_id(std::size_t a_offset) const;
 
+		// Locates an offset for symbolication: the ID of the function holding
+		// it according to the module's .pdata, else the greatest ID at or
+		// below it. Empty if no ID lies at or below the offset.
+		[[nodiscard]] std::optional<LOCATION> get_location(std::size_t a_offset) const;
+
+		// Locates a batch of absolute addresses, such as a call stack, in one
+		// sweep over the sorted queries. Results are in the order given and
+		// misses are reported in them; this never terminates the process.
+		[[nodiscard]] std::vector<SYMBOL> symbolize(std::span<const std::uintptr_t> a_addresses) const;
+
 		[[nodiscard]] const_iterator begin() const noexcept { return _offset2id.begin(); }
-		[[nodiscard]] const_iterator cbegin() const noexcept { return _offset2id.cbegin(); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return _offset2id.begin(); }
 
 		[[nodiscard]] const_iterator end() const noexcept { return _offset2id.end(); }
-		[[nodiscard]] const_iterator cend() const noexcept { return _offset2id.cend(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return _offset2id.end(); }
 
 		[[nodiscard]] const_reverse_iterator rbegin() const noexcept { return _offset2id.rbegin(); }
-		[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return _offset2id.crbegin(); }
+		[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return _offset2id.rbegin(); }
 
 		[[nodiscard]] const_reverse_iterator rend() const noexcept { return _offset2id.rend(); }
-		[[nodiscard]] const_reverse_iterator crend() const noexcept { return _offset2id.crend(); }
+		[[nodiscard]] const_reverse_iterator crend() const noexcept { return _offset2id.rend(); }
 
 		[[nodiscard]] size_type size() const noexcept { return _offset2id.size(); }
 
+		// The offset-sorted table, usually mapped from memory shared between
+		// modules; copy it into a container_type to own it
+		[[nodiscard]] view_type view() const noexcept { return _offset2id; }
+
 	private:
-		container_type _offset2id;
+		// A .pdata function, with any chained fragment mapped to the start
+		// of its primary function, and the ID found there.
+		struct FUNCTION
+		{
+			static constexpr auto npos{ static_cast<std::uint64_t>(-1) };
+
+			std::uint32_t begin;
+			std::uint32_t end;
+			std::uint32_t primary;
+			std::uint64_t id;
+		};
+
+		using function_iterator = typename std::vector<FUNCTION>::const_iterator;
+
+		void build_functions() const;
+
+		// Locates `a_offset` given the first function and mapping that
+		// start above it.
+		[[nodiscard]] std::optional<LOCATION> locate(std::size_t a_offset, function_iterator a_function, const_iterator a_mapping) const noexcept;
+
+		[[nodiscard]] const_iterator upper_bound(std::size_t a_offset) const noexcept;
+
+		// Attaches to the offset-sorted table shared by every module, or
+		// builds it from the `a_count` mappings `a_fill` writes if this is
+		// the first module to ask for it.
+		void load(std::size_t a_count, const std::function<void(std::span<value_type>)>& a_fill);
+
+		REX::MemoryMap _mmap;
+		container_type _private;
+		view_type      _offset2id;
+
+		mutable std::once_flag        _functionsBuilt;
+		mutable std::vector<FUNCTION> _functions;
 	};
 }
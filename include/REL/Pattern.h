@@ -28,6 +28,15 @@ namespace REL
 			{
 				return a_ch == '?';
 			}
+
+			[[nodiscard]] constexpr std::uint8_t hexadecimal_value(const char a_ch) noexcept
+			{
+				if ('0' <= a_ch && a_ch <= '9')
+					return static_cast<std::uint8_t>(a_ch - '0');
+				if ('A' <= a_ch && a_ch <= 'F')
+					return static_cast<std::uint8_t>(a_ch - 'A' + 0xA);
+				return static_cast<std::uint8_t>(a_ch - 'a' + 0xa);
+			}
 		}
 
 		namespace rules
@@ -70,12 +79,12 @@ namespace REL
 			class Hexadecimal
 			{
 			public:
+				static constexpr std::byte value{ detail::hexacharacters_to_hexadecimal(HI, LO) };
+				static constexpr std::byte mask{ 0xFF };
+
 				[[nodiscard]] static constexpr bool match(const std::byte a_byte) noexcept
 				{
-					constexpr auto expected = detail::hexacharacters_to_hexadecimal(
-						HI,
-						LO);
-					return a_byte == expected;
+					return a_byte == value;
 				}
 			};
 
@@ -94,6 +103,9 @@ namespace REL
 			class Wildcard
 			{
 			public:
+				static constexpr std::byte value{ 0x00 };
+				static constexpr std::byte mask{ 0x00 };
+
 				[[nodiscard]] static constexpr bool match(std::byte) noexcept
 				{
 					return true;
@@ -125,6 +137,13 @@ namespace REL
 				sizeof...(Rules) >= 1,
 				"must provide at least 1 rule for the pattern matcher");
 
+			[[nodiscard]] static constexpr std::size_t size() noexcept { return sizeof...(Rules); }
+
+			// The pattern as bytes and masks: a byte matches `value` if
+			// `(byte & mask) == value`, so wildcards have a zero mask.
+			[[nodiscard]] static constexpr std::array<std::byte, sizeof...(Rules)> bytes() noexcept { return { Rules::value... }; }
+			[[nodiscard]] static constexpr std::array<std::byte, sizeof...(Rules)> masks() noexcept { return { Rules::mask... }; }
+
 			[[nodiscard]] constexpr bool match(
 				std::span<const std::byte, sizeof...(Rules)> a_bytes) const noexcept
 			{
@@ -218,4 +237,98 @@ namespace REL
 		detail::make_byte_array(0x40, 0x10, 0xF2, 0x41)));
 	static_assert(Pattern<"B8 D0 ?? ?? D4 6E">().match(
 		detail::make_byte_array(0xB8, 0xD0, 0x35, 0x2A, 0xD4, 0x6E)));
+	static_assert(Pattern<"E8 ?? 4C">().bytes() == detail::make_byte_array(0xE8, 0x00, 0x4C));
+	static_assert(Pattern<"E8 ?? 4C">().masks() == detail::make_byte_array(0xFF, 0x00, 0xFF));
+
+	// A pattern parsed at runtime, such as a signature read from a config
+	// file. It uses the syntax of `Pattern<>`, and a `?` may also stand for
+	// a single nibble: "48 8B ?? 4? ?F" matches 0x4A in the fourth byte and
+	// 0x3F in the fifth.
+	class RuntimePattern
+	{
+	public:
+		constexpr RuntimePattern() noexcept = default;
+
+		// Empty if the string is not a valid pattern.
+		[[nodiscard]] static constexpr std::optional<RuntimePattern> parse(const std::string_view a_pattern)
+		{
+			RuntimePattern result;
+			for (std::size_t i = 0;;) {
+				if (a_pattern.size() - i < 2)
+					return std::nullopt;
+
+				std::uint8_t value = 0;
+				std::uint8_t mask = 0;
+				for (const auto ch : { a_pattern[i], a_pattern[i + 1] }) {
+					value = static_cast<std::uint8_t>(value << 4);
+					mask = static_cast<std::uint8_t>(mask << 4);
+					if (detail::characters::hexadecimal(ch)) {
+						value |= detail::characters::hexadecimal_value(ch);
+						mask |= 0xF;
+					} else if (!detail::characters::wildcard(ch)) {
+						return std::nullopt;
+					}
+				}
+
+				result.m_bytes.push_back(static_cast<std::byte>(value));
+				result.m_masks.push_back(static_cast<std::byte>(mask));
+
+				i += 2;
+				if (i == a_pattern.size())
+					return result;
+				if (!detail::characters::space(a_pattern[i++]))
+					return std::nullopt;
+			}
+		}
+
+		[[nodiscard]] constexpr std::size_t size() const noexcept { return m_bytes.size(); }
+
+		// A byte matches `bytes()[i]` if `(byte & masks()[i]) == bytes()[i]`.
+		[[nodiscard]] constexpr std::span<const std::byte> bytes() const noexcept { return m_bytes; }
+		[[nodiscard]] constexpr std::span<const std::byte> masks() const noexcept { return m_masks; }
+
+		// Whether `a_bytes` starts with the pattern.
+		[[nodiscard]] constexpr bool match(const std::span<const std::byte> a_bytes) const noexcept
+		{
+			if (a_bytes.size() < size())
+				return false;
+
+			for (std::size_t i = 0; i < size(); ++i) {
+				if ((a_bytes[i] & m_masks[i]) != m_bytes[i])
+					return false;
+			}
+			return true;
+		}
+
+		[[nodiscard]] bool match(const std::uintptr_t a_address) const noexcept
+		{
+			return this->match(std::span{ reinterpret_cast<const std::byte*>(a_address), size() });
+		}
+
+	private:
+		std::vector<std::byte> m_bytes;
+		std::vector<std::byte> m_masks;
+	};
+
+	static_assert(RuntimePattern::parse("40 10 F2 ??")->match(
+		detail::make_byte_array(0x40, 0x10, 0xF2, 0x41)));
+	static_assert(RuntimePattern::parse("B8 D0 ?? ?? D4 6E")->match(
+		detail::make_byte_array(0xB8, 0xD0, 0x35, 0x2A, 0xD4, 0x6E)));
+	static_assert(RuntimePattern::parse("4? ?f")->match(
+		detail::make_byte_array(0x4A, 0x3F)));
+	static_assert(!RuntimePattern::parse("4? ?F")->match(
+		detail::make_byte_array(0x5A, 0x3F)));
+	static_assert(!RuntimePattern::parse("4? ?F")->match(
+		detail::make_byte_array(0x4A, 0x3E)));
+	static_assert(!RuntimePattern::parse("40 10")->match(
+		detail::make_byte_array(0x40)));
+	static_assert(RuntimePattern::parse("E8 ?? 4?")->masks()[2] == std::byte{ 0xF0 });
+
+	static_assert(!RuntimePattern::parse(""));
+	static_assert(!RuntimePattern::parse("4"));
+	static_assert(!RuntimePattern::parse("40 1"));
+	static_assert(!RuntimePattern::parse("40 "));
+	static_assert(!RuntimePattern::parse("4010"));
+	static_assert(!RuntimePattern::parse("40  10"));
+	static_assert(!RuntimePattern::parse("40 1G"));
 }
@@ -25,6 +25,7 @@ namespace REL
 #include "REL/Offset2ID.h"
 #include "REL/Pattern.h"
 #include "REL/Relocation.h"
+#include "REL/Scan.h"
 #include "REL/Segment.h"
 #include "REL/Trampoline.h"
 #include "REL/Utility.h"
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "REX/BASE.h"
+
+#include "REL/Module.h"
+#include "REL/Pattern.h"
+#include "REL/ScanCore.h"
+#include "REL/Segment.h"
+
+namespace REL
+{
+	namespace detail
+	{
+#ifdef COMMONLIB_OPTION_SCAN_CACHE
+		// Matches recorded by earlier launches of the same executable, as
+		// offsets from the module base. A lookup succeeds only if `a_verify`
+		// accepts every recorded match, otherwise the entry is dropped so
+		// the caller scans and stores it again.
+		[[nodiscard]] std::uint64_t scan_cache_key(const Segment& a_segment, std::span<const std::byte> a_bytes, std::span<const std::byte> a_masks, std::uint32_t a_search) noexcept;
+
+		[[nodiscard]] std::optional<std::vector<std::uint64_t>> scan_cache_find(std::uint64_t a_key, const std::function<bool(std::uint64_t)>& a_verify);
+		void                                                    scan_cache_store(std::uint64_t a_key, std::vector<std::uint64_t> a_records);
+#endif
+
+		// Finds the first or every match of a pattern that provides
+		// `bytes()`, `masks()` and `match(address)`.
+		template <class P>
+		[[nodiscard]] std::vector<std::uintptr_t> find_matches(const Segment& a_segment, const P& a_pattern, const bool a_all)
+		{
+			const auto bytes = a_pattern.bytes();
+			const auto masks = a_pattern.masks();
+
+#ifdef COMMONLIB_OPTION_SCAN_CACHE
+			const auto base = ModuleBase::GetSingleton()->base();
+			const auto key = scan_cache_key(a_segment, bytes, masks, a_all ? 1 : 0);
+			const auto cached = scan_cache_find(key, [&](const std::uint64_t a_record) {
+				const auto address = base + a_record;
+				return address >= a_segment.address() &&
+				       address - a_segment.address() + bytes.size() <= a_segment.size() &&
+				       a_pattern.match(address);
+			});
+			if (cached) {
+				std::vector<std::uintptr_t> result;
+				for (const auto record : *cached)
+					result.push_back(base + record);
+				return result;
+			}
+#endif
+
+			const auto range = std::span{ a_segment.pointer<const std::byte>(), a_segment.size() };
+			const auto starts = scan_matches(range, bytes.size(), scan_anchor(bytes, masks), a_all, [&](const std::byte* a_start) {
+				return a_pattern.match(reinterpret_cast<std::uintptr_t>(a_start));
+			});
+
+			std::vector<std::uintptr_t> result;
+			for (const auto start : starts)
+				result.push_back(reinterpret_cast<std::uintptr_t>(start));
+
+#ifdef COMMONLIB_OPTION_SCAN_CACHE
+			std::vector<std::uint64_t> records;
+			for (const auto address : result)
+				records.push_back(address - base);
+			scan_cache_store(key, std::move(records));
+#endif
+
+			return result;
+		}
+	}
+
+	// Finds the first match of a pattern in a segment, such as
+	// `REL::Scan(REL::Pattern<"48 8B 05 ?? ?? ?? ?? C3">())`.
+	template <class... Rules>
+	[[nodiscard]] std::optional<std::uintptr_t> Scan(const Segment& a_segment, const detail::PatternMatcher<Rules...>& a_pattern)
+	{
+		const auto matches = detail::find_matches(a_segment, a_pattern, false);
+		return matches.empty() ? std::nullopt : std::optional{ matches.front() };
+	}
+
+	template <class... Rules>
+	[[nodiscard]] std::optional<std::uintptr_t> Scan(const detail::PatternMatcher<Rules...>& a_pattern)
+	{
+		return Scan(detail::ModuleBase::GetSingleton()->segment(Segment::text), a_pattern);
+	}
+
+	// Finds every match of a pattern in a segment, in ascending order.
+	// Matches may overlap.
+	template <class... Rules>
+	[[nodiscard]] std::vector<std::uintptr_t> ScanAll(const Segment& a_segment, const detail::PatternMatcher<Rules...>& a_pattern)
+	{
+		return detail::find_matches(a_segment, a_pattern, true);
+	}
+
+	template <class... Rules>
+	[[nodiscard]] std::vector<std::uintptr_t> ScanAll(const detail::PatternMatcher<Rules...>& a_pattern)
+	{
+		return ScanAll(detail::ModuleBase::GetSingleton()->segment(Segment::text), a_pattern);
+	}
+
+	// Writes the matches recorded so far to the scan cache now, e.g. once
+	// the plugin has installed its hooks, instead of relying on static
+	// destruction. Later changes are still written at exit. Does nothing
+	// without the scan cache option or before the first scan.
+	void FlushScanCache();
+
+	[[nodiscard]] std::optional<std::uintptr_t> Scan(const Segment& a_segment, const RuntimePattern& a_pattern);
+	[[nodiscard]] std::optional<std::uintptr_t> Scan(const RuntimePattern& a_pattern);
+	[[nodiscard]] std::vector<std::uintptr_t>   ScanAll(const Segment& a_segment, const RuntimePattern& a_pattern);
+	[[nodiscard]] std::vector<std::uintptr_t>   ScanAll(const RuntimePattern& a_pattern);
+
+	// Many patterns compiled into one matcher that finds all of them in a
+	// single pass over a segment. Patterns are bucketed by a 2-byte anchor,
+	// so the cost of a scan barely depends on how many are registered.
+	class PatternSet
+	{
+	public:
+		struct MATCH
+		{
+			std::size_t    pattern;  // index returned by add()
+			std::uintptr_t address;
+		};
+
+		// Adds a pattern and returns its index.
+		template <class... Rules>
+		std::size_t add(const detail::PatternMatcher<Rules...>&)
+		{
+			static constexpr auto bytes = detail::PatternMatcher<Rules...>::bytes();
+			static constexpr auto masks = detail::PatternMatcher<Rules...>::masks();
+			return add(bytes, masks);
+		}
+
+		std::size_t add(const RuntimePattern& a_pattern) { return add(a_pattern.bytes(), a_pattern.masks()); }
+
+		// Adds a pattern given as bytes and masks, as returned by
+		// `PatternMatcher::bytes()` and `masks()`, and returns its index.
+		std::size_t add(std::span<const std::byte> a_bytes, std::span<const std::byte> a_masks);
+
+		// Finds every match of every pattern, ordered by address, then by
+		// pattern index.
+		[[nodiscard]] std::vector<MATCH> scan(const Segment& a_segment) const;
+		[[nodiscard]] std::vector<MATCH> scan() const;
+
+		[[nodiscard]] std::size_t size() const noexcept { return m_patterns.size(); }
+		[[nodiscard]] bool        empty() const noexcept { return m_patterns.empty(); }
+
+	private:
+		struct PATTERN
+		{
+			std::size_t first;  // into m_bytes and m_masks
+			std::size_t length;
+		};
+
+		struct ENTRY
+		{
+			std::uint16_t key;     // the anchor bytes, first byte lowest
+			std::uint16_t offset;  // of the anchor in the pattern
+			std::uint32_t pattern;
+		};
+
+		[[nodiscard]] bool match(const PATTERN& a_pattern, const std::byte* a_start) const noexcept;
+
+		[[nodiscard]] std::vector<MATCH> sweep(const Segment& a_segment) const;
+
+		std::vector<std::byte>                  m_bytes;
+		std::vector<std::byte>                  m_masks;
+		std::vector<PATTERN>                    m_patterns;
+		std::vector<ENTRY>                      m_entries;     // sorted by key
+		std::vector<std::uint32_t>              m_unanchored;  // checked at every position
+		std::array<std::uint64_t, 0x10000 / 64> m_keys{};      // bit per anchor key in m_entries
+	};
+}
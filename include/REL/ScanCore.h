@@ -0,0 +1,223 @@
+#pragma once
+
+// Segment scanning shared by REL::Scan and the scan test. Only the standard
+// library and SSE2/AVX2 intrinsics are used so the test builds off Windows.
+
+#include "REX/REX/Parallel.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <immintrin.h>
+#include <span>
+#include <vector>
+
+namespace REL
+{
+	namespace detail
+	{
+		// The bytes a scan searches for before verifying the whole pattern:
+		// the pair of adjacent bytes with the fewest wildcard bits, and the
+		// rarest in x64 code among those. `size` is 1 for a 1-byte pattern,
+		// and 0 if the pattern has no pair with a fixed bit.
+		struct SCAN_ANCHOR
+		{
+			std::size_t              offset{ 0 };
+			std::size_t              size{ 0 };
+			std::array<std::byte, 2> value{};
+			std::array<std::byte, 2> mask{};
+		};
+
+		// Bytes that are most frequent in x64 machine code, most frequent
+		// first: padding, REX prefixes, mov/lea/call opcodes, ModRM bytes
+		// addressing the stack and common small displacements
+		inline constexpr std::array COMMON_BYTES{
+			0x00, 0xCC, 0x48, 0x8B, 0xFF, 0x89, 0x24, 0x4C, 0xE8, 0x0F, 0x44, 0x8D,
+			0x01, 0x85, 0xC0, 0x74, 0x83, 0x08, 0x10, 0x20, 0x40, 0x4D, 0x45, 0x33,
+			0xC3, 0x49, 0x41, 0x75, 0xC7, 0x28, 0x30, 0x38, 0x18, 0x90, 0x0D, 0xEB,
+			0xF8, 0xD2, 0xC9, 0x84, 0x02, 0x04, 0x50, 0x58, 0x60, 0x68, 0x70, 0x78,
+			0x80, 0xE9, 0x05, 0x15, 0xD8, 0x4E, 0x66, 0x5C, 0xC8, 0x8E
+		};
+
+		// Estimated frequency of each byte, higher is more frequent
+		inline constexpr auto FREQUENCY = []() noexcept {
+			std::array<std::uint8_t, 256> result{};
+			for (std::size_t i = 0; i < COMMON_BYTES.size(); ++i) {
+				result[COMMON_BYTES[i]] = static_cast<std::uint8_t>(COMMON_BYTES.size() - i);
+			}
+			return result;
+		}();
+
+		// Bytes each scan thread should at least get, as spawning a thread
+		// costs about as much as scanning a megabyte
+		inline constexpr std::size_t SCAN_GRAIN{ 1 << 20 };
+
+		[[nodiscard]] inline std::uint32_t frequency(const std::byte a_byte) noexcept
+		{
+			return FREQUENCY[std::to_integer<std::size_t>(a_byte)];
+		}
+
+		// Picks the anchor of a pattern given as bytes and masks
+		[[nodiscard]] inline SCAN_ANCHOR scan_anchor(const std::span<const std::byte> a_bytes, const std::span<const std::byte> a_masks) noexcept
+		{
+			const auto wildcards = [&](std::size_t a_pos) {
+				return static_cast<std::uint32_t>(8 - std::popcount(std::to_integer<std::uint8_t>(a_masks[a_pos])));
+			};
+			const auto fixed = [&](std::size_t a_pos) {
+				return a_masks[a_pos] == std::byte{ 0xFF } ? frequency(a_bytes[a_pos]) : 0u;
+			};
+
+			if (a_bytes.size() == 1) {
+				if (wildcards(0) == 8)
+					return {};
+
+				const auto value = a_bytes[0] & a_masks[0];
+				return { 0, 1, { value, value }, { a_masks[0], a_masks[0] } };
+			}
+
+			SCAN_ANCHOR   result;
+			std::uint32_t bestWildcards = 16;
+			std::uint32_t bestFrequency = 0;
+			for (std::size_t i = 0; i + 1 < a_bytes.size(); ++i) {
+				const auto count = wildcards(i) + wildcards(i + 1);
+				const auto score = fixed(i) + fixed(i + 1);
+				if (count < bestWildcards || (count == bestWildcards && score < bestFrequency)) {
+					bestWildcards = count;
+					bestFrequency = score;
+					result = { i, 2, { a_bytes[i] & a_masks[i], a_bytes[i + 1] & a_masks[i + 1] }, { a_masks[i], a_masks[i + 1] } };
+				}
+			}
+
+			return result;
+		}
+
+		// Calls `a_visit` with every position in `a_range` where a pattern of
+		// `a_length` bytes holding `a_anchor` could start, in ascending order,
+		// until it returns true.
+		inline void scan(
+			const std::span<const std::byte>             a_range,
+			const std::size_t                            a_length,
+			const SCAN_ANCHOR&                           a_anchor,
+			const std::function<bool(const std::byte*)>& a_visit)
+		{
+			if (a_length == 0 || a_range.size() < a_length)
+				return;
+
+			const auto first = a_range.data();
+			const auto count = a_range.size() - a_length + 1;  // possible starts
+			if (a_anchor.size == 0) {
+				for (std::size_t i = 0; i < count; ++i) {
+					if (a_visit(first + i))
+						return;
+				}
+				return;
+			}
+
+			// Byte `i` of `lo` and `hi` is the anchor of the start `i`. A
+			// 1-byte anchor compares the same byte twice. The anchor lies
+			// within the pattern, so no load reads past the range.
+			const auto lo = first + a_anchor.offset;
+			const auto hi = lo + (a_anchor.size - 1);
+
+			std::size_t i = 0;
+			const auto  visit = [&](std::uint32_t a_mask) {
+				for (; a_mask; a_mask &= a_mask - 1) {
+					if (a_visit(first + i + static_cast<std::size_t>(std::countr_zero(a_mask))))
+						return true;
+				}
+				return false;
+			};
+
+#ifdef __AVX2__
+			const auto lo32 = _mm256_set1_epi8(static_cast<char>(a_anchor.value[0]));
+			const auto hi32 = _mm256_set1_epi8(static_cast<char>(a_anchor.value[1]));
+			const auto loMask32 = _mm256_set1_epi8(static_cast<char>(a_anchor.mask[0]));
+			const auto hiMask32 = _mm256_set1_epi8(static_cast<char>(a_anchor.mask[1]));
+			for (; i + 32 <= count; i += 32) {
+				const auto match = _mm256_and_si256(
+					_mm256_cmpeq_epi8(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo + i)), loMask32), lo32),
+					_mm256_cmpeq_epi8(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi + i)), hiMask32), hi32));
+				if (visit(static_cast<std::uint32_t>(_mm256_movemask_epi8(match))))
+					return;
+			}
+#endif
+
+			const auto lo16 = _mm_set1_epi8(static_cast<char>(a_anchor.value[0]));
+			const auto hi16 = _mm_set1_epi8(static_cast<char>(a_anchor.value[1]));
+			const auto loMask16 = _mm_set1_epi8(static_cast<char>(a_anchor.mask[0]));
+			const auto hiMask16 = _mm_set1_epi8(static_cast<char>(a_anchor.mask[1]));
+			for (; i + 16 <= count; i += 16) {
+				const auto match = _mm_and_si128(
+					_mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lo + i)), loMask16), lo16),
+					_mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hi + i)), hiMask16), hi16));
+				if (visit(static_cast<std::uint32_t>(_mm_movemask_epi8(match))))
+					return;
+			}
+
+			for (; i < count; ++i) {
+				if ((lo[i] & a_anchor.mask[0]) == a_anchor.value[0] && (hi[i] & a_anchor.mask[1]) == a_anchor.value[1] && a_visit(first + i))
+					return;
+			}
+		}
+
+		// Finds the starts in `a_range` where `a_match` accepts a pattern of
+		// `a_length` bytes holding `a_anchor`: all of them, in ascending
+		// order, or only the first. Ranges of more than `a_grain` starts are
+		// split between threads, so `a_match` must be safe to call
+		// concurrently.
+		[[nodiscard]] inline std::vector<const std::byte*> scan_matches(
+			const std::span<const std::byte>             a_range,
+			const std::size_t                            a_length,
+			const SCAN_ANCHOR&                           a_anchor,
+			const bool                                   a_all,
+			const std::function<bool(const std::byte*)>& a_match,
+			const std::size_t                            a_grain = SCAN_GRAIN)
+		{
+			if (a_length == 0 || a_range.size() < a_length)
+				return {};
+
+			// Each chunk owns a run of starts and reads up to `a_length - 1`
+			// bytes past it. Chunks overlap by the pattern, but no start is
+			// reported twice.
+			const auto                                 count = a_range.size() - a_length + 1;
+			const auto                                 workers = REX::PARALLEL_WORKERS(count, a_grain);
+			std::vector<std::vector<const std::byte*>> chunks(workers);
+
+			// Lowest chunk with a match; when only the first match is wanted,
+			// chunks above it stop early
+			std::atomic<std::size_t> found{ workers };
+
+			REX::PARALLEL_FOR(workers, [&](const std::size_t a_worker) {
+				const auto begin = count * a_worker / workers;
+				const auto end = count * (a_worker + 1) / workers;
+				auto&      matches = chunks[a_worker];
+				scan(a_range.subspan(begin, end - begin + a_length - 1), a_length, a_anchor, [&](const std::byte* a_start) {
+					if (!a_all && found.load(std::memory_order_relaxed) < a_worker)
+						return true;
+					if (!a_match(a_start))
+						return false;
+
+					matches.push_back(a_start);
+					if (a_all)
+						return false;
+
+					auto current = found.load(std::memory_order_relaxed);
+					while (a_worker < current && !found.compare_exchange_weak(current, a_worker, std::memory_order_relaxed)) {}
+					return true;
+				});
+			});
+
+			// Chunks are in address order, so joining them keeps the order
+			std::vector<const std::byte*> result;
+			for (const auto& matches : chunks) {
+				if (!a_all && !matches.empty())
+					return { matches.front() };
+				result.insert(result.end(), matches.begin(), matches.end());
+			}
+			return result;
+		}
+	}
+}
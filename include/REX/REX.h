@@ -10,8 +10,10 @@
 #include "REX/REX/JSON.h"
 #include "REX/REX/LOG.h"
 #include "REX/REX/MemoryMap.h"
+#include "REX/REX/Parallel.h"
 #include "REX/REX/ScopeExit.h"
 #include "REX/REX/Setting.h"
+#include "REX/REX/SharedRegion.h"
 #include "REX/REX/Singleton.h"
 #include "REX/REX/StaticString.h"
 #include "REX/REX/TOML.h"
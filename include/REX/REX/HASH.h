@@ -6,7 +6,27 @@
 
 namespace REX
 {
-	inline std::optional<std::string> SHA512(std::span<const std::byte> a_data)
+	// FNV-1a over 64-bit words, for cache keys and checksums. Not suitable
+	// where an attacker controls the input.
+	[[nodiscard]] inline std::uint64_t FNV1A_64(std::span<const std::byte> a_data, std::uint64_t a_hash = 0xCBF29CE484222325) noexcept
+	{
+		constexpr std::uint64_t PRIME = 0x100000001B3;
+
+		std::size_t i = 0;
+		for (; i + sizeof(std::uint64_t) <= a_data.size(); i += sizeof(std::uint64_t)) {
+			std::uint64_t word;
+			std::memcpy(&word, a_data.data() + i, sizeof(word));
+			a_hash = (a_hash ^ word) * PRIME;
+		}
+		for (; i < a_data.size(); ++i)
+			a_hash = (a_hash ^ static_cast<std::uint64_t>(a_data[i])) * PRIME;
+
+		return a_hash;
+	}
+
+	using SHA512_DIGEST = std::array<std::uint8_t, 64>;
+
+	inline std::optional<SHA512_DIGEST> SHA512_RAW(std::span<const std::byte> a_data)
 	{
 		REX::W32::BCRYPT_ALG_HANDLE algorithm;
 		if (!REX::W32::NT_SUCCESS(REX::W32::BCryptOpenAlgorithmProvider(&algorithm, REX::W32::BCRYPT_SHA512_ALGORITHM)))
@@ -31,16 +51,25 @@ namespace REX
 
 		std::uint32_t length{ 0 };
 		std::uint32_t output{ 0 };
-		if (!REX::W32::NT_SUCCESS(REX::W32::BCryptGetProperty(hash, REX::W32::BCRYPT_HASH_LENGTH, reinterpret_cast<std::uint8_t*>(&length), sizeof(length), &output)))
+		if (!REX::W32::NT_SUCCESS(REX::W32::BCryptGetProperty(hash, REX::W32::BCRYPT_HASH_LENGTH, reinterpret_cast<std::uint8_t*>(&length), sizeof(length), &output)) || length != sizeof(SHA512_DIGEST))
+			return std::nullopt;
+
+		SHA512_DIGEST digest;
+		if (!REX::W32::NT_SUCCESS(REX::W32::BCryptFinishHash(hash, digest.data(), static_cast<std::uint32_t>(digest.size()))))
 			return std::nullopt;
 
-		std::vector<std::uint8_t> buffer(static_cast<std::size_t>(length));
-		if (!REX::W32::NT_SUCCESS(REX::W32::BCryptFinishHash(hash, buffer.data(), static_cast<std::uint32_t>(buffer.size()))))
+		return digest;
+	}
+
+	inline std::optional<std::string> SHA512(std::span<const std::byte> a_data)
+	{
+		const auto digest = SHA512_RAW(a_data);
+		if (!digest)
 			return std::nullopt;
 
 		std::string result;
-		result.reserve(buffer.size() * 2);
-		for (const auto byte : buffer) {
+		result.reserve(digest->size() * 2);
+		for (const auto byte : *digest) {
 			result += std::format("{:02X}", byte);
 		}
 
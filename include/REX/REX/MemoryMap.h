@@ -10,8 +10,30 @@ namespace REX
 
 	public:
 		MemoryMap() = default;
+		MemoryMap(const MemoryMap&) = delete;
+
+		MemoryMap(MemoryMap&& a_rhs) noexcept
+		{
+			*this = std::move(a_rhs);
+		}
+
 		~MemoryMap() { close(); }
 
+		MemoryMap& operator=(const MemoryMap&) = delete;
+
+		MemoryMap& operator=(MemoryMap&& a_rhs) noexcept
+		{
+			if (this != &a_rhs) {
+				close();
+				m_file = std::exchange(a_rhs.m_file, REX::W32::INVALID_HANDLE_VALUE);
+				m_map = std::exchange(a_rhs.m_map, nullptr);
+				m_mapView = std::exchange(a_rhs.m_mapView, nullptr);
+				m_size = std::exchange(a_rhs.m_size, 0);
+				m_owner = std::exchange(a_rhs.m_owner, false);
+			}
+			return *this;
+		}
+
 	public:
 		void close()
 		{
@@ -27,7 +49,7 @@ namespace REX
 
 			if (m_file != REX::W32::INVALID_HANDLE_VALUE) {
 				REX::W32::CloseHandle(m_file);
-				m_file = nullptr;
+				m_file = REX::W32::INVALID_HANDLE_VALUE;
 			}
 
 			m_size = 0;
@@ -0,0 +1,32 @@
+#pragma once
+
+// Only the standard library is used so offline tools can share it.
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace REX
+{
+	// Number of threads worth spawning for a pass over `a_count` elements,
+	// given that each thread should get at least `a_grain` of them.
+	[[nodiscard]] inline std::size_t PARALLEL_WORKERS(const std::size_t a_count, const std::size_t a_grain = 1 << 16) noexcept
+	{
+		const auto hardware = static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency()));
+		return std::clamp<std::size_t>(a_count / a_grain, 1, hardware);
+	}
+
+	// Runs `a_func(i)` for every i in [0, a_workers), the last one on the
+	// calling thread, and returns once all of them have finished.
+	template <class F>
+	void PARALLEL_FOR(const std::size_t a_workers, F&& a_func)
+	{
+		std::vector<std::jthread> threads;
+		threads.reserve(a_workers - 1);
+		for (std::size_t i = 0; i + 1 < a_workers; ++i)
+			threads.emplace_back(a_func, i);
+
+		a_func(a_workers - 1);
+	}
+}
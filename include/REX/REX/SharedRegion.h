@@ -0,0 +1,104 @@
+#pragma once
+
+#include "REX/BASE.h"
+
+#include "REX/REX/AtomicRef.h"
+
+#include <chrono>
+
+namespace REX
+{
+	// Publication protocol for a memory region shared between modules or
+	// processes. A HEADER in front of the payload lets exactly one caller
+	// fill it while everyone else waits until it has been published.
+	//
+	// Only lock-free atomics on the mapped memory are used, so the protocol
+	// works over any shared mapping; the OS must zero-fill new regions.
+	class SharedRegion
+	{
+	public:
+		enum class Role : std::uint32_t
+		{
+			Build,     // fill the payload, then call publish()
+			Use,       // the payload has been published and may be read
+			Fallback,  // not published in time, or by an incompatible writer
+		};
+
+		struct alignas(64) HEADER
+		{
+			std::uint64_t magic;
+			std::uint32_t layout;
+			std::uint32_t state;
+			std::uint32_t generation;
+			std::uint32_t pad;
+			std::uint64_t size;
+		};
+
+		SharedRegion(std::byte* a_base, const std::uint64_t a_magic, const std::uint32_t a_layout) noexcept :
+			m_header(reinterpret_cast<HEADER*>(a_base)),
+			m_magic(a_magic),
+			m_layout(a_layout)
+		{}
+
+		// Claims the region for building, or waits up to `a_timeout` for
+		// another caller to publish a payload of `a_size` bytes.
+		Role acquire(const std::uint64_t a_size, const std::chrono::milliseconds a_timeout)
+		{
+			TAtomicRef state(m_header->state);
+
+			const auto deadline = std::chrono::steady_clock::now() + a_timeout;
+			for (std::uint32_t spins = 0;; ++spins) {
+				auto current = state.load(std::memory_order_acquire);
+				if (current == EMPTY && state.compare_exchange_strong(current, BUILDING, std::memory_order_acq_rel)) {
+					m_header->magic = m_magic;
+					m_header->layout = m_layout;
+					m_header->size = a_size;
+					return Role::Build;
+				}
+
+				if (current == READY) {
+					const bool valid = m_header->magic == m_magic && m_header->layout == m_layout && m_header->size == a_size;
+					return valid ? Role::Use : Role::Fallback;
+				}
+
+				if (std::chrono::steady_clock::now() >= deadline)
+					return Role::Fallback;
+
+				// Waiting on an address does not cross process boundaries, so poll
+				if (spins < 64)
+					std::this_thread::yield();
+				else
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		// Makes everything written to the payload visible to other callers.
+		void publish() noexcept
+		{
+			TAtomicRef(m_header->generation).fetch_add(1, std::memory_order_relaxed);
+			TAtomicRef(m_header->state).store(READY, std::memory_order_release);
+		}
+
+		// Gives up a claimed region without publishing a payload, so waiting
+		// callers fall back at once instead of timing out.
+		void abandon() noexcept
+		{
+			m_header->magic = 0;
+			TAtomicRef(m_header->state).store(READY, std::memory_order_release);
+		}
+
+		[[nodiscard]] std::byte* payload() const noexcept { return reinterpret_cast<std::byte*>(m_header + 1); }
+
+		[[nodiscard]] std::uint32_t generation() const noexcept { return TAtomicRef(m_header->generation).load(std::memory_order_acquire); }
+
+	private:
+		static constexpr std::uint32_t EMPTY{ 0 };
+		static constexpr std::uint32_t BUILDING{ 1 };
+		static constexpr std::uint32_t READY{ 2 };
+
+		HEADER*       m_header;
+		std::uint64_t m_magic;
+		std::uint32_t m_layout;
+	};
+	static_assert(sizeof(SharedRegion::HEADER) == 64);
+}
@@ -284,6 +284,14 @@ namespace REX::W32
 	};
 	static_assert(sizeof(IMAGE_NT_HEADERS64) == 0x108);
 
+	struct IMAGE_RUNTIME_FUNCTION_ENTRY
+	{
+		std::uint32_t beginAddress;
+		std::uint32_t endAddress;
+		std::uint32_t unwindInfoAddress;
+	};
+	static_assert(sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY) == 0xC);
+
 	struct IMAGE_SECTION_HEADER
 	{
 		std::uint8_t name[IMAGE_SIZEOF_SHORT_NAME];
@@ -489,6 +497,7 @@ namespace REX::W32
 	std::uint32_t         GetCurrentDirectoryW(std::uint32_t a_size, wchar_t* a_buffer) noexcept;
 	HMODULE               GetCurrentModule() noexcept;
 	HANDLE                GetCurrentProcess() noexcept;
+	std::uint32_t         GetCurrentProcessId() noexcept;
 	std::uint32_t         GetCurrentThreadId() noexcept;
 	std::uint32_t         GetEnvironmentVariableA(const char* a_name, char* a_buf, std::uint32_t a_bufLen) noexcept;
 	std::uint32_t         GetEnvironmentVariableW(const wchar_t* a_name, wchar_t* a_buf, std::uint32_t a_bufLen) noexcept;
@@ -1,11 +1,14 @@
 #include "REL/IDDB.h"
+#include "REL/ID.h"
 #include "REL/Module.h"
 #include "REL/Version.h"
 
 #include "REX/REX/HASH.h"
 #include "REX/REX/LOG.h"
+#include "REX/REX/Parallel.h"
 #include "REX/W32/KERNEL32.h"
 #include <algorithm>
+#include <charconv>
 #include <cstring>
 
 namespace REL
@@ -48,8 +51,31 @@ namespace REL
 			return val;
 		}
 
-		// Get underlying stream for text-based formats like CSV
-		stream_type& get_stream() { return _stream; }
+		std::streampos tell()
+		{
+			return _stream.tellg();
+		}
+
+		void seek(const std::streampos a_pos)
+		{
+			_stream.clear();
+			_stream.seekg(a_pos);
+		}
+
+		// Read everything past the current position in a single call. The
+		// returned buffer carries `a_padding` trailing zero bytes so decoders
+		// may over-read by a few words without bounds checks.
+		std::vector<std::byte> readall(const std::size_t a_padding)
+		{
+			const auto pos = _stream.tellg();
+			_stream.seekg(0, std::ios::end);
+			const auto size = static_cast<std::size_t>(_stream.tellg() - pos);
+			_stream.seekg(pos);
+
+			std::vector<std::byte> buffer(size + a_padding);
+			_stream.read(std::bit_cast<char*>(buffer.data()), static_cast<std::streamsize>(size));
+			return buffer;
+		}
 
 	private:
 		stream_type _stream;
@@ -128,6 +154,332 @@ namespace REL
 
 namespace REL
 {
+	namespace
+	{
+		using namespace codec;
+
+		// Identifies a source database by path, size and last write time.
+		struct FILE_IDENTITY
+		{
+			std::uint64_t pathHash{ 0 };
+			std::uint64_t size{ 0 };
+			std::int64_t  time{ 0 };
+
+			bool operator==(const FILE_IDENTITY&) const = default;
+		};
+
+		std::optional<FILE_IDENTITY> file_identity(const std::filesystem::path& a_path)
+		{
+			std::error_code ec;
+			const auto      size = std::filesystem::file_size(a_path, ec);
+			if (ec)
+				return std::nullopt;
+
+			const auto time = std::filesystem::last_write_time(a_path, ec);
+			if (ec)
+				return std::nullopt;
+
+			const auto& native = a_path.native();
+			return FILE_IDENTITY{
+				REX::FNV1A_64(std::as_bytes(std::span{ native })),
+				static_cast<std::uint64_t>(size),
+				static_cast<std::int64_t>(time.time_since_epoch().count())
+			};
+		}
+
+		// Decoded V1/V2/CSV mappings, sorted by ID, stored next to the source
+		// database so later launches can map them without decoding.
+		struct CACHE_HEADER
+		{
+			static constexpr std::uint64_t MAGIC{ 0x43424444494C4C43 };  // "CLLIDDBC"
+			static constexpr std::uint32_t LAYOUT{ 1 };
+
+			std::uint64_t magic{ MAGIC };
+			std::uint32_t layout{ LAYOUT };
+			std::int32_t  format{ 0 };
+			std::uint16_t gameVersion[4]{};
+			FILE_IDENTITY source;
+			std::uint64_t count{ 0 };
+			std::uint64_t checksum{ 0 };
+		};
+		static_assert(sizeof(CACHE_HEADER) % alignof(IDDB::MAPPING) == 0);
+
+		// Header of the shared table in the compact layout
+		constexpr std::uint64_t TABLE_MAGIC{ 0x3233424444494C43 };  // "CLIDDB32"
+		constexpr std::uint32_t TABLE_LAYOUT{ 1 };
+
+		// How long to wait for another module to publish the shared table
+		// before decoding a private copy instead
+		constexpr std::chrono::milliseconds TABLE_TIMEOUT{ 5000 };
+
+#ifndef COMMONLIB_OPTION_IDDB_LEGACY_LAYOUT
+		// Whether IDs and offsets fit the 32-bit arrays of the compact layout
+		bool fits_compact(std::span<const IDDB::MAPPING> a_mappings) noexcept
+		{
+			constexpr auto max = std::numeric_limits<std::uint32_t>::max();
+			return std::ranges::all_of(a_mappings, [](auto&& a_mapping) {
+				return a_mapping.id <= max && a_mapping.offset <= max;
+			});
+		}
+#endif
+
+		// Kept next to the database rather than the plugin, so every plugin
+		// maps the one cache and an updated database is never paired with a
+		// cache left elsewhere.
+		std::filesystem::path cache_path(const std::filesystem::path& a_source)
+		{
+			auto path = a_source;
+			path += L".cache";
+			return path;
+		}
+
+		// Parses a SHA-512 written as 128 hexadecimal digits.
+		consteval REX::SHA512_DIGEST parse_digest(const std::string_view a_hex)
+		{
+			const auto nibble = [](const char a_char) {
+				if (a_char >= '0' && a_char <= '9')
+					return static_cast<std::uint8_t>(a_char - '0');
+				if (a_char >= 'A' && a_char <= 'F')
+					return static_cast<std::uint8_t>(a_char - 'A' + 10);
+				if (a_char >= 'a' && a_char <= 'f')
+					return static_cast<std::uint8_t>(a_char - 'a' + 10);
+				throw "invalid hexadecimal digit";
+			};
+
+			if (a_hex.size() != std::tuple_size_v<REX::SHA512_DIGEST> * 2)
+				throw "invalid SHA-512 length";
+
+			REX::SHA512_DIGEST digest{};
+			for (std::size_t i = 0; i < digest.size(); ++i)
+				digest[i] = static_cast<std::uint8_t>(nibble(a_hex[i * 2]) << 4 | nibble(a_hex[i * 2 + 1]));
+			return digest;
+		}
+
+		// SHA-512 of a source database stored next to it, so the blacklist
+		// check only hashes the file again once it has changed.
+		struct DIGEST_CACHE
+		{
+			static constexpr std::uint64_t MAGIC{ 0x4148534444494C43 };  // "CLIDDSHA"
+
+			std::uint64_t      magic{ MAGIC };
+			FILE_IDENTITY      source;
+			std::uint64_t      sample{ 0 };
+			REX::SHA512_DIGEST digest{};
+		};
+
+		// Hashes the head and tail of a file, which catches rewrites that
+		// keep both its size and last write time.
+		std::uint64_t sample_bytes(std::span<const std::byte> a_data) noexcept
+		{
+			constexpr std::size_t SAMPLE{ 64 * 1024 };
+
+			const auto length = std::min(SAMPLE, a_data.size());
+			return REX::FNV1A_64(a_data.last(length), REX::FNV1A_64(a_data.first(length)));
+		}
+
+		std::optional<REX::SHA512_DIGEST> cached_digest(const std::filesystem::path& a_path, std::span<const std::byte> a_data)
+		{
+			const auto identity = file_identity(a_path);
+			if (!identity)
+				return REX::SHA512_RAW(a_data);
+
+			auto path = a_path;
+			path += L".sha512";
+
+			const auto   sample = sample_bytes(a_data);
+			DIGEST_CACHE cache;
+			{
+				std::ifstream file(path, std::ios::in | std::ios::binary);
+				if (file.read(reinterpret_cast<char*>(&cache), sizeof(cache)) &&
+					cache.magic == DIGEST_CACHE::MAGIC &&
+					cache.source == *identity &&
+					cache.sample == sample)
+					return cache.digest;
+			}
+
+			const auto digest = REX::SHA512_RAW(a_data);
+			if (!digest)
+				return std::nullopt;
+
+			cache = { DIGEST_CACHE::MAGIC, *identity, sample, *digest };
+
+			// Failing to store it only means hashing again on the next launch
+			auto temp = path;
+			temp += std::format(L".{}", REX::W32::GetCurrentProcessId());
+			{
+				std::ofstream file(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+				file.write(reinterpret_cast<const char*>(&cache), sizeof(cache));
+			}
+
+			std::error_code ec;
+			std::filesystem::rename(temp, path, ec);
+			if (ec)
+				std::filesystem::remove(temp, ec);
+
+			return digest;
+		}
+
+		// Worker started by IDDB::Prefetch(); joined by ~IDDB so it never
+		// runs on inside a module being unloaded
+		std::jthread& prefetch_thread()
+		{
+			static std::jthread thread;
+			return thread;
+		}
+
+		using Phase = IDDB::STATS::Phase;
+
+#ifdef COMMONLIB_OPTION_IDDB_STATS
+		// Lookup counters owned by one thread; the lock is only ever
+		// contended while stats() aggregates them.
+		struct THREAD_STATS
+		{
+			std::mutex                                       lock;
+			std::uint64_t                                    lookups{ 0 };
+			std::uint64_t                                    misses{ 0 };
+			std::unordered_map<std::uint64_t, std::uint64_t> ids;
+		};
+
+		struct GLOBAL_STATS
+		{
+			std::array<std::atomic<std::int64_t>, IDDB::STATS::PHASE_COUNT> phases{};
+			std::mutex                                                       lock;
+			std::vector<std::shared_ptr<THREAD_STATS>>                       threads;
+		};
+
+		// Constructed by the first load phase, so it outlives the IDDB
+		GLOBAL_STATS& global_stats()
+		{
+			static GLOBAL_STATS stats;
+			return stats;
+		}
+
+		THREAD_STATS& thread_stats()
+		{
+			thread_local const auto stats = []() {
+				auto                   result = std::make_shared<THREAD_STATS>();
+				auto&                  global = global_stats();
+				const std::scoped_lock lock(global.lock);
+				global.threads.push_back(result);
+				return result;
+			}();
+			return *stats;
+		}
+
+		void record_stats(const std::uint64_t a_id, const bool a_hit)
+		{
+			auto&                  stats = thread_stats();
+			const std::scoped_lock lock(stats.lock);
+			++stats.lookups;
+			stats.misses += !a_hit;
+			++stats.ids[a_id];
+		}
+
+		// Adds the time until stop() or destruction to a load phase.
+		class PHASE_TIMER
+		{
+		public:
+			explicit PHASE_TIMER(const Phase a_phase) noexcept :
+				m_phase(a_phase),
+				m_start(std::chrono::steady_clock::now())
+			{}
+
+			PHASE_TIMER(const PHASE_TIMER&) = delete;
+			~PHASE_TIMER() { stop(); }
+
+			PHASE_TIMER& operator=(const PHASE_TIMER&) = delete;
+
+			void stop() noexcept
+			{
+				if (m_stopped)
+					return;
+
+				const auto elapsed = std::chrono::steady_clock::now() - m_start;
+				global_stats().phases[std::to_underlying(m_phase)] += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+				m_stopped = true;
+			}
+
+		private:
+			Phase                                 m_phase;
+			std::chrono::steady_clock::time_point m_start;
+			bool                                  m_stopped{ false };
+		};
+#else
+		class PHASE_TIMER
+		{
+		public:
+			explicit PHASE_TIMER(Phase) noexcept {}
+
+			void stop() noexcept {}
+		};
+#endif
+
+#ifdef COMMONLIB_OPTION_IDDB_MANIFEST
+		// IDs resolved by one thread, merged when the manifest is written
+		struct THREAD_MANIFEST
+		{
+			std::mutex                        lock;
+			std::unordered_set<std::uint64_t> ids;
+		};
+
+		struct GLOBAL_MANIFEST
+		{
+			std::mutex                                    lock;
+			std::vector<std::shared_ptr<THREAD_MANIFEST>> threads;
+			std::mutex                                    writeLock;
+			std::size_t                                   written{ 0 };  // IDs in the last file written
+		};
+
+		// Constructed by the IDDB constructor, so it outlives the IDDB
+		GLOBAL_MANIFEST& global_manifest()
+		{
+			static GLOBAL_MANIFEST manifest;
+			return manifest;
+		}
+
+		void record_resolved(const std::uint64_t a_id)
+		{
+			thread_local const auto manifest = []() {
+				auto                   result = std::make_shared<THREAD_MANIFEST>();
+				auto&                  global = global_manifest();
+				const std::scoped_lock lock(global.lock);
+				global.threads.push_back(result);
+				return result;
+			}();
+
+			const std::scoped_lock lock(manifest->lock);
+			manifest->ids.insert(a_id);
+		}
+
+		// IDs a plugin resolved in one session, stored next to the plugin as
+		// ascending IDs in LEB128-encoded deltas.
+		struct MANIFEST_HEADER
+		{
+			static constexpr std::uint64_t MAGIC{ 0x464F525044494C43 };  // "CLIDPROF"
+			static constexpr std::uint32_t LAYOUT{ 1 };
+
+			std::uint64_t magic{ MAGIC };
+			std::uint32_t layout{ LAYOUT };
+			std::uint32_t runtime{ 0 };
+			std::uint16_t gameVersion[4]{};
+			std::uint64_t count{ 0 };
+			std::uint64_t size{ 0 };
+			std::uint64_t checksum{ 0 };
+		};
+#endif
+
+		void record_lookup([[maybe_unused]] const std::uint64_t a_id, [[maybe_unused]] const bool a_hit)
+		{
+#ifdef COMMONLIB_OPTION_IDDB_STATS
+			record_stats(a_id, a_hit);
+#endif
+#ifdef COMMONLIB_OPTION_IDDB_MANIFEST
+			if (a_hit)
+				record_resolved(a_id);
+#endif
+		}
+	}
+
 	IDDB::IDDB()
 	{
 		std::unordered_map<IDDB::Loader, std::vector<std::wstring>> g_rootMap{
@@ -144,6 +496,11 @@ namespace REL
 			{ IDDB::Loader::OBSE, { "OBSE", L"OBSE" } },
 		};
 
+		// Outlives the IDDB, so ~IDDB can join a running prefetch
+		prefetch_thread();
+
+		PHASE_TIMER discover(Phase::Discover);
+
 		wchar_t buffer[REX::W32::MAX_PATH];
 		REX::W32::GetModuleFileNameW(REX::W32::GetCurrentModule(), buffer, REX::W32::MAX_PATH);
 		std::filesystem::path plugin(buffer);
@@ -187,19 +544,97 @@ namespace REL
 		if (m_path.empty())
 			REX::FAIL("Failed to determine Address Library path!\nLoader: {}", g_loaderMap[m_loader].first);
 
+		discover.stop();
+		load();
+		m_index.build(m_table);
+
+		// Lazy databases collect their IDs while building the restart points
+		if (m_lazy.empty() && !m_table.empty()) {
+			m_presence.reserve(m_table.size());
+			for (std::size_t i = 0; i < m_table.size(); ++i)
+				m_presence.set(m_table.id(i));
+			m_presence.finish();
+		}
+
+#ifdef COMMONLIB_OPTION_IDDB_MANIFEST
+		// Outlives the IDDB, so ~IDDB can still write what was recorded
+		global_manifest();
+
+		m_manifest = plugin;
+		m_manifest.replace_extension(L".idmanifest");
+		preload();
+#endif
+	}
+
+	IDDB::~IDDB()
+	{
+		// Constructed by Prefetch() or the constructor, so still alive here
+		if (auto& prefetch = prefetch_thread(); prefetch.joinable())
+			prefetch.join();
+
+#ifdef COMMONLIB_OPTION_IDDB_MANIFEST
+		if (m_preload.joinable())
+			m_preload.join();
+
+		// Only writes if IDs were resolved since the last flush()
+		write_manifest();
+#endif
+
+#ifdef COMMONLIB_OPTION_IDDB_STATS
+		constexpr std::array PHASE_NAMES{ "discover"sv, "open"sv, "header"sv, "decode"sv, "sort"sv, "validate"sv, "map"sv };
+		static_assert(PHASE_NAMES.size() == STATS::PHASE_COUNT);
+
+		const auto  summary = stats(5);
+		std::string line = "Address Library stats:";
+		for (std::size_t i = 0; i < STATS::PHASE_COUNT; ++i)
+			line += std::format(" {} {:.3f}ms,", PHASE_NAMES[i], std::chrono::duration<double, std::milli>(summary.phases[i]).count());
+		line += std::format(" {} lookups, {} misses", summary.lookups, summary.misses);
+		for (std::size_t i = 0; i < summary.top.size(); ++i)
+			line += std::format("{} {} ({})", i == 0 ? ", top IDs:" : ",", summary.top[i].first, summary.top[i].second);
+
+		REX::INFO("{}", line);
+#endif
+	}
+
+	void IDDB::Prefetch()
+	{
+		static std::once_flag started;
+		std::call_once(started, []() {
+			// Concurrent GetSingleton() calls wait on the static's guard
+			prefetch_thread() = std::jthread([]() {
+				try {
+					GetSingleton();
+				} catch (...) {
+					// Load failures terminate through REX::FAIL; anything else
+					// leaves the singleton unbuilt, so the next GetSingleton()
+					// constructs again and throws on its caller
+				}
+			});
+		});
+	}
+
+	void IDDB::load()
+	{
 		if (m_format == Format::V0) {
 			load_v0();
 			return;
 		}
 
+#ifdef COMMONLIB_OPTION_IDDB_CACHE
+		if (load_cache())
+			return;
+#endif
+
 		if (m_format == Format::CSV) {
-			STREAM stream(m_path, std::ios::in);
-			load_csv(stream);
+			load_csv();
 			return;
 		}
 
-		STREAM     stream(m_path, std::ios::in | std::ios::binary);
-		const auto format = stream.readout<std::uint32_t>();
+		PHASE_TIMER open(Phase::Open);
+		STREAM      stream(m_path, std::ios::in | std::ios::binary);
+		const auto  format = stream.readout<std::uint32_t>();
+		open.stop();
+
 		if (format < 1 || (format > 2 && format < 5) || format > 5)
 			REX::FAIL("Unsupported Address Library format: {}", format);
 
@@ -215,21 +650,27 @@ namespace REL
 	{
 		const auto mod = detail::ModuleBase::GetSingleton();
 		const auto mapName = std::format("COMMONLIB_IDDB_OFFSETS_{}", mod->version().string("_"));
+
+		PHASE_TIMER map(Phase::Map);
 		if (!m_mmap.create(false, m_path, mapName))
 			REX::FAIL(L"Failed to create Address Library MemoryMap!\nError: {}\nPath: {}", REX::W32::GetLastError(), m_path.wstring());
+		map.stop();
 
-		validate_file();
+		validate_file(m_mmap);
 
 		m_v0 = {
 			reinterpret_cast<MAPPING*>(m_mmap.data() + sizeof(std::uint64_t)),
 			*reinterpret_cast<std::uint64_t*>(m_mmap.data())
 		};
+		m_table = TABLE{ m_v0 };
 	}
 
 	void IDDB::load_v2(STREAM& a_stream)
 	{
 		try {
-			HEADER_V2 header(a_stream);
+			PHASE_TIMER parse(Phase::Header);
+			HEADER_V2   header(a_stream);
+			parse.stop();
 
 			const auto mod = detail::ModuleBase::GetSingleton();
 			if (header.game_version() != mod->version()) {
@@ -240,33 +681,88 @@ namespace REL
 					mod->version().string(), header.game_version().string());
 			}
 
-			const auto mapName = std::format("COMMONLIB_IDDB_OFFSETS_{}", mod->version().string("_"));
-			const auto byteSize = static_cast<std::size_t>(header.address_count()) * sizeof(MAPPING);
-			if (!m_mmap.create(true, mapName, byteSize))
+#ifdef COMMONLIB_OPTION_IDDB_LAZY
+			if (load_lazy(a_stream, header))
+				return;
+#endif
+
+			if (!map_table(header.address_count()))
 				REX::FAIL("Failed to create Address Library MemoryMap!\nError: {}", REX::W32::GetLastError());
 
-			validate_file();
+			validate_file(m_mmap);
+
+			const auto role = claim_table(header.address_count(), TABLE_TIMEOUT);
+			if (role == REX::SharedRegion::Role::Use)
+				return;
+
+			// The wide layout is decoded in place, the compact one packed
+			// from a private buffer once sorted
+			std::vector<MAPPING> buffer;
+			std::span<MAPPING>   mappings = m_v0;
+			if (mappings.empty()) {
+				buffer.resize(header.address_count());
+				mappings = buffer;
+			}
+
+			PHASE_TIMER decode(Phase::Decode);
+			const bool  ordered = unpack_file(a_stream, header, mappings);
+			decode.stop();
+
+			// IDs are delta-encoded and almost always ascending already
+			if (!ordered) {
+				const PHASE_TIMER timer(Phase::Sort);
+				sort(mappings, &MAPPING::id);
+			}
 
-			m_v0 = { reinterpret_cast<MAPPING*>(m_mmap.data()), header.address_count() };
+			if (role == REX::SharedRegion::Role::Fallback) {
+				REX::WARN("Shared Address Library table was not published in time, using a private copy");
+				keep_private(std::move(buffer));
+				return;
+			}
 
-			if (m_mmap.is_owner()) {
-				unpack_file(a_stream, header);
-				std::sort(
-					m_v0.begin(),
-					m_v0.end(),
-					[](auto&& a_lhs, auto&& a_rhs) {
-						return a_lhs.id < a_rhs.id;
-					});
+#ifndef COMMONLIB_OPTION_IDDB_LEGACY_LAYOUT
+			if (!fits_compact(mappings)) {
+				REX::WARN("Address Library mappings do not fit the compact shared layout, using a private copy");
+				REX::SharedRegion(m_mmap.data(), TABLE_MAGIC, TABLE_LAYOUT).abandon();
+				keep_private(std::move(buffer));
+#	ifdef COMMONLIB_OPTION_IDDB_CACHE
+				write_cache(m_private);
+#	endif
+				return;
 			}
+#endif
+
+			fill_table(mappings);
+#ifdef COMMONLIB_OPTION_IDDB_CACHE
+			write_cache(mappings);
+#endif
 		} catch (const std::system_error&) {
 			REX::FAIL(L"Failed to open Address Library file!\nPath: {}", m_path.wstring());
 		}
 	}
 
+	bool IDDB::load_lazy(STREAM& a_stream, const HEADER_V2& a_header)
+	{
+		const PHASE_TIMER timer(Phase::Decode);
+
+		const auto pos = a_stream.tell();
+		try {
+			if (m_lazy.build(a_stream.readall(DELTA_PADDING), a_header.address_count(), a_header.pointer_size(), m_presence))
+				return true;
+		} catch (const std::bad_alloc&) {
+		}
+
+		REX::WARN("Address Library cannot be decoded lazily, falling back to a full decode");
+		a_stream.seek(pos);
+		return false;
+	}
+
 	void IDDB::load_v5(STREAM& a_stream)
 	{
 		try {
-			HEADER_V5 header(a_stream);
+			PHASE_TIMER parse(Phase::Header);
+			HEADER_V5   header(a_stream);
+			parse.stop();
 
 			const auto mod = detail::ModuleBase::GetSingleton();
 			if (header.game_version() != mod->version()) {
@@ -278,10 +774,13 @@ namespace REL
 			}
 
 			const auto mapName = std::format("COMMONLIB_IDDB_OFFSETS_{}", mod->version().string("_"));
+
+			PHASE_TIMER map(Phase::Map);
 			if (!m_mmap.create(false, m_path, mapName))
 				REX::FAIL(L"Failed to create Address Library MemoryMap!\nError: {}\nPath: {}", REX::W32::GetLastError(), m_path.wstring());
+			map.stop();
 
-			validate_file();
+			validate_file(m_mmap);
 
 			m_v5 = { reinterpret_cast<std::uint32_t*>(m_mmap.data() + sizeof(HEADER_V5)), header.offset_count() };
 
@@ -290,223 +789,868 @@ namespace REL
 		}
 	}
 
-	void IDDB::load_csv(STREAM& a_stream)
+	void IDDB::load_csv()
 	{
-		try {
-			std::vector<MAPPING> mappings;
-			std::string          line;
-			std::size_t          lineNumber = 0;
-			std::size_t          validEntries = 0;
-			std::size_t          invalidEntries = 0;
-			std::size_t          duplicateEntries = 0;
-			std::size_t          expectedEntries = 0;
-			std::string          versionString;
-
-			// 1. Read and skip header line (id,offset)
-			if (std::getline(a_stream.get_stream(), line)) {
-				lineNumber++;
-			}
-			// 2. Parse metadata line (entry count, version string)
-			if (std::getline(a_stream.get_stream(), line)) {
-				lineNumber++;
-				size_t commaPos = line.find(',');
-				if (commaPos != std::string::npos) {
-					std::string countStr = line.substr(0, commaPos);
-					std::string verStr = line.substr(commaPos + 1);
-					countStr.erase(0, countStr.find_first_not_of(" \t\r\n"));
-					countStr.erase(countStr.find_last_not_of(" \t\r\n") + 1);
-					verStr.erase(0, verStr.find_first_not_of(" \t\r\n"));
-					verStr.erase(verStr.find_last_not_of(" \t\r\n") + 1);
-					try {
-						expectedEntries = std::stoull(countStr);
-						versionString = verStr;
-						REX::INFO("CSV Address Library metadata: expected entries = {}, version = {}", expectedEntries, versionString);
-					} catch (const std::exception&) {
-						REX::WARN("CSV metadata line {}: Could not parse entry count or version string. Line: '{}'", lineNumber, line);
-					}
+		const auto mod = detail::ModuleBase::GetSingleton();
+
+		PHASE_TIMER    open(Phase::Open);
+		REX::MemoryMap source;
+		const auto     sourceName = std::format("COMMONLIB_IDDB_CSV_{}", mod->version().string("_"));
+		if (!source.create(false, m_path, sourceName))
+			REX::FAIL(L"Failed to open CSV Address Library file!\nPath: {}", m_path.wstring());
+		open.stop();
+
+		PHASE_TIMER decode(Phase::Decode);
+
+		std::string_view text{ reinterpret_cast<const char*>(source.data()), source.size() };
+		std::size_t      lineNumber = 0;
+		std::size_t      expectedEntries = 0;
+
+		// 1. Read and skip header line (id,offset)
+		if (!text.empty()) {
+			next_line(text);
+			lineNumber++;
+		}
+		// 2. Parse metadata line (entry count, version string)
+		if (!text.empty()) {
+			const auto line = next_line(text);
+			lineNumber++;
+			const auto commaPos = line.find(',');
+			if (commaPos != std::string_view::npos) {
+				const auto countStr = trim(line.substr(0, commaPos));
+				const auto verStr = trim(line.substr(commaPos + 1));
+				if (parse_integer(countStr, expectedEntries, false) == std::errc{}) {
+					REX::INFO("CSV Address Library metadata: expected entries = {}, version = {}", expectedEntries, verStr);
 				} else {
-					REX::WARN("CSV metadata line {}: Invalid format (missing comma). Line: '{}'", lineNumber, line);
-				}
-			}
-			// 3. Parse CSV lines: id,offset
-			while (std::getline(a_stream.get_stream(), line)) {
-				lineNumber++;
-				if (line.empty() || line[0] == '#') {
-					continue;  // Skip empty lines and comments
-				}
-				size_t commaPos = line.find(',');
-				if (commaPos == std::string::npos) {
-					REX::WARN("CSV line {}: Invalid format (missing comma). Line: '{}'", lineNumber, line);
-					invalidEntries++;
-					continue;
-				}
-				std::string idStr = line.substr(0, commaPos);
-				std::string offsetStr = line.substr(commaPos + 1);
-				idStr.erase(0, idStr.find_first_not_of(" \t\r\n"));
-				idStr.erase(idStr.find_last_not_of(" \t\r\n") + 1);
-				offsetStr.erase(0, offsetStr.find_first_not_of(" \t\r\n"));
-				offsetStr.erase(offsetStr.find_last_not_of(" \t\r\n") + 1);
-				if (idStr.empty() || offsetStr.empty()) {
-					REX::WARN("CSV line {}: Empty ID or offset value. Line: '{}'", lineNumber, line);
-					invalidEntries++;
-					continue;
-				}
-				try {
-					std::uint64_t id = std::stoull(idStr);
-					std::uint64_t offset = std::stoull(offsetStr);
-					auto          it = std::find_if(mappings.begin(), mappings.end(),
-								 [id](const MAPPING& mapping) { return mapping.id == id; });
-					if (it != mappings.end()) {
-						REX::WARN("CSV line {}: Duplicate ID {} (previous offset: 0x{:X}, new offset: 0x{:X})",
-							lineNumber, id, it->offset, offset);
-						duplicateEntries++;
-						it->offset = offset;
-					} else {
-						mappings.emplace_back(id, offset);
-						validEntries++;
-					}
-				} catch (const std::invalid_argument&) {
-					REX::WARN("CSV line {}: Invalid number format. Line: '{}'", lineNumber, line);
-					invalidEntries++;
-				} catch (const std::out_of_range&) {
-					REX::WARN("CSV line {}: Number out of range. Line: '{}'", lineNumber, line);
-					invalidEntries++;
+					expectedEntries = 0;
+					REX::WARN("CSV metadata line {}: Could not parse entry count or version string. Line: '{}'", lineNumber, line);
 				}
+			} else {
+				REX::WARN("CSV metadata line {}: Invalid format (missing comma). Line: '{}'", lineNumber, line);
 			}
-			if (mappings.empty()) {
-				REX::FAIL("No valid mappings found in CSV Address Library file!");
-			}
-			std::sort(mappings.begin(), mappings.end(),
-				[](const MAPPING& a_lhs, const MAPPING& a_rhs) {
-					return a_lhs.id < a_rhs.id;
-				});
-			const auto mod = detail::ModuleBase::GetSingleton();
-			const auto mapName = std::format("COMMONLIB_IDDB_OFFSETS_{}", mod->version().string("_"));
-			const auto byteSize = mappings.size() * sizeof(MAPPING);
-			if (!m_mmap.create(true, mapName, byteSize)) {
-				REX::FAIL("Failed to create CSV Address Library MemoryMap!\nError: {}", REX::W32::GetLastError());
-			}
-			std::memcpy(m_mmap.data(), mappings.data(), byteSize);
-			m_v0 = { reinterpret_cast<MAPPING*>(m_mmap.data()), mappings.size() };
-			REX::INFO("CSV Address Library loaded successfully:");
-			REX::INFO("  - Valid entries: {}", validEntries);
-			if (invalidEntries > 0) {
-				REX::WARN("  - Invalid entries: {}", invalidEntries);
+		}
+		// 3. Parse CSV lines: id,offset, split into newline-aligned chunks
+		const auto workers = REX::PARALLEL_WORKERS(text.size(), 1 << 20);
+
+		std::vector<std::string_view> chunkText(workers);
+		for (std::size_t i = 0, begin = 0; i < workers; ++i) {
+			auto end = i + 1 < workers ? std::max(begin, text.size() * (i + 1) / workers) : text.size();
+			if (end < text.size()) {
+				const auto newline = text.find('\n', end);
+				end = newline != std::string_view::npos ? newline + 1 : text.size();
 			}
-			if (duplicateEntries > 0) {
-				REX::WARN("  - Duplicate entries: {} (latest values used)", duplicateEntries);
+			chunkText[i] = text.substr(begin, end - begin);
+			begin = end;
+		}
+
+		std::vector<CSV_CHUNK> chunks(workers);
+		REX::PARALLEL_FOR(workers, [&](const std::size_t a_worker) {
+			parse_csv_chunk(chunkText[a_worker], chunks[a_worker]);
+		});
+
+		std::vector<MAPPING>     entries;
+		std::vector<std::size_t> entryLines;
+		std::vector<CSV_DIAG>    diags;
+		std::size_t              invalidEntries = 0;
+		for (auto& chunk : chunks) {
+			const auto base = lineNumber + 1;
+			for (auto& diag : chunk.diags)
+				diag.line += base;
+			for (auto& line : chunk.lines)
+				line += base;
+
+			entries.insert(entries.end(), chunk.mappings.begin(), chunk.mappings.end());
+			entryLines.insert(entryLines.end(), chunk.lines.begin(), chunk.lines.end());
+			diags.insert(diags.end(), chunk.diags.begin(), chunk.diags.end());
+			invalidEntries += chunk.diags.size();
+			lineNumber += chunk.lineCount;
+		}
+		decode.stop();
+
+		// 4. Sort (stable, so duplicates keep file order) and keep the latest value per ID
+		PHASE_TIMER          order(Phase::Sort);
+		std::vector<MAPPING> mappings(entries);
+		sort(mappings, &MAPPING::id);
+
+		std::unordered_set<std::uint64_t> duplicateIDs;
+		std::size_t                       unique = 0;
+		for (std::size_t i = 0; i < mappings.size(); ++i) {
+			if (i + 1 < mappings.size() && mappings[i].id == mappings[i + 1].id) {
+				duplicateIDs.insert(mappings[i].id);
+				continue;
 			}
-			REX::INFO("  - Total unique entries: {}", mappings.size());
-			if (expectedEntries > 0 && expectedEntries != mappings.size()) {
-				REX::WARN("CSV entry count mismatch: metadata = {}, actual = {}", expectedEntries, mappings.size());
+			mappings[unique++] = mappings[i];
+		}
+		const auto duplicateEntries = mappings.size() - unique;
+		mappings.resize(unique);
+		order.stop();
+
+		if (!duplicateIDs.empty()) {
+			std::unordered_map<std::uint64_t, std::uint64_t> previous;
+			std::vector<CSV_DIAG>                            duplicates;
+			for (std::size_t i = 0; i < entries.size(); ++i) {
+				const auto& entry = entries[i];
+				if (!duplicateIDs.contains(entry.id))
+					continue;
+
+				const auto [it, inserted] = previous.try_emplace(entry.id, entry.offset);
+				if (!inserted) {
+					duplicates.push_back({ CSV_DIAG::Kind::Duplicate, entryLines[i], {}, entry.id, it->second, entry.offset });
+					it->second = entry.offset;
+				}
 			}
-		} catch (const std::system_error&) {
-			REX::FAIL(L"Failed to open CSV Address Library file!\nPath: {}", m_path.wstring());
+
+			std::vector<CSV_DIAG> merged;
+			merged.reserve(diags.size() + duplicates.size());
+			std::ranges::merge(diags, duplicates, std::back_inserter(merged), {}, &CSV_DIAG::line, &CSV_DIAG::line);
+			diags = std::move(merged);
 		}
-	}
 
-	void IDDB::unpack_file(STREAM& a_stream, const HEADER_V2& a_header)
-	{
-		std::uint8_t  type = 0;
-		std::uint64_t id = 0;
-		std::uint64_t offset = 0;
-		std::uint64_t prevID = 0;
-		std::uint64_t prevOffset = 0;
-		for (auto& mapping : m_v0) {
-			a_stream.readin(type);
-			const auto lo = static_cast<std::uint8_t>(type & 0xF);
-			const auto hi = static_cast<std::uint8_t>(type >> 4);
-
-			switch (lo) {
-				case 0:
-					a_stream.readin(id);
+		for (const auto& diag : diags) {
+			switch (diag.kind) {
+				case CSV_DIAG::Kind::MissingComma:
+					REX::WARN("CSV line {}: Invalid format (missing comma). Line: '{}'", diag.line, diag.text);
 					break;
-				case 1:
-					id = prevID + 1;
+				case CSV_DIAG::Kind::Empty:
+					REX::WARN("CSV line {}: Empty ID or offset value. Line: '{}'", diag.line, diag.text);
 					break;
-				case 2:
-					id = prevID + a_stream.readout<std::uint8_t>();
+				case CSV_DIAG::Kind::Invalid:
+					REX::WARN("CSV line {}: Invalid number format. Line: '{}'", diag.line, diag.text);
 					break;
-				case 3:
-					id = prevID - a_stream.readout<std::uint8_t>();
+				case CSV_DIAG::Kind::OutOfRange:
+					REX::WARN("CSV line {}: Number out of range. Line: '{}'", diag.line, diag.text);
 					break;
-				case 4:
-					id = prevID + a_stream.readout<std::uint16_t>();
+				case CSV_DIAG::Kind::Duplicate:
+					REX::WARN("CSV line {}: Duplicate ID {} (previous offset: 0x{:X}, new offset: 0x{:X})",
+						diag.line, diag.id, diag.previous, diag.offset);
 					break;
-				case 5:
-					id = prevID - a_stream.readout<std::uint16_t>();
+			}
+		}
+
+		if (mappings.empty()) {
+			REX::FAIL("No valid mappings found in CSV Address Library file!");
+		}
+#ifndef COMMONLIB_OPTION_IDDB_LEGACY_LAYOUT
+		const bool shared = fits_compact(mappings);
+		if (!shared)
+			REX::WARN("CSV Address Library mappings do not fit the compact shared layout, using a private copy");
+#else
+		constexpr bool shared = true;
+#endif
+		if (!shared) {
+			keep_private(mappings);
+#ifdef COMMONLIB_OPTION_IDDB_CACHE
+			write_cache(mappings);
+#endif
+		} else {
+			if (!map_table(mappings.size())) {
+				REX::FAIL("Failed to create CSV Address Library MemoryMap!\nError: {}", REX::W32::GetLastError());
+			}
+			// Every process has parsed the file by now, so never wait for another
+			switch (claim_table(mappings.size(), std::chrono::milliseconds::zero())) {
+				case REX::SharedRegion::Role::Build:
+					fill_table(mappings);
+#ifdef COMMONLIB_OPTION_IDDB_CACHE
+					write_cache(mappings);
+#endif
 					break;
-				case 6:
-					id = a_stream.readout<std::uint16_t>();
+				case REX::SharedRegion::Role::Use:
 					break;
-				case 7:
-					id = a_stream.readout<std::uint32_t>();
+				case REX::SharedRegion::Role::Fallback:
+					keep_private(mappings);
 					break;
-				default:
-					REX::FAIL("Unhandled type while loading Address Library!");
 			}
+		}
+		REX::INFO("CSV Address Library loaded successfully:");
+		REX::INFO("  - Valid entries: {}", mappings.size());
+		if (invalidEntries > 0) {
+			REX::WARN("  - Invalid entries: {}", invalidEntries);
+		}
+		if (duplicateEntries > 0) {
+			REX::WARN("  - Duplicate entries: {} (latest values used)", duplicateEntries);
+		}
+		REX::INFO("  - Total unique entries: {}", mappings.size());
+		if (expectedEntries > 0 && expectedEntries != mappings.size()) {
+			REX::WARN("CSV entry count mismatch: metadata = {}, actual = {}", expectedEntries, mappings.size());
+		}
+	}
 
-			const std::uint64_t tmp = (hi & 8) != 0 ? (prevOffset / a_header.pointer_size()) : prevOffset;
+	// Creates or opens the shared table for `a_count` mappings. The compact
+	// layout uses its own name so processes built with either layout never
+	// read each other's table.
+	bool IDDB::map_table(const std::size_t a_count)
+	{
+		const PHASE_TIMER timer(Phase::Map);
 
-			switch (hi & 7) {
-				case 0:
-					a_stream.readin(offset);
-					break;
-				case 1:
-					offset = tmp + 1;
-					break;
-				case 2:
-					offset = tmp + a_stream.readout<std::uint8_t>();
-					break;
-				case 3:
-					offset = tmp - a_stream.readout<std::uint8_t>();
-					break;
-				case 4:
-					offset = tmp + a_stream.readout<std::uint16_t>();
-					break;
-				case 5:
-					offset = tmp - a_stream.readout<std::uint16_t>();
-					break;
-				case 6:
-					offset = a_stream.readout<std::uint16_t>();
-					break;
-				case 7:
-					offset = a_stream.readout<std::uint32_t>();
+		const auto mod = detail::ModuleBase::GetSingleton();
+#ifdef COMMONLIB_OPTION_IDDB_LEGACY_LAYOUT
+		const auto mapName = std::format("COMMONLIB_IDDB_OFFSETS_{}", mod->version().string("_"));
+		if (!m_mmap.create(true, mapName, a_count * sizeof(MAPPING)))
+			return false;
+
+		m_v0 = { reinterpret_cast<MAPPING*>(m_mmap.data()), a_count };
+		m_table = TABLE{ m_v0 };
+#else
+		const auto mapName = std::format("COMMONLIB_IDDB_OFFSETS32_{}", mod->version().string("_"));
+		if (!m_mmap.create(true, mapName, sizeof(REX::SharedRegion::HEADER) + a_count * 2 * sizeof(std::uint32_t)))
+			return false;
+
+		const REX::SharedRegion region(m_mmap.data(), TABLE_MAGIC, TABLE_LAYOUT);
+		const auto              ids = reinterpret_cast<const std::uint32_t*>(region.payload());
+		m_table = { ids, ids + a_count, a_count };
+#endif
+		return true;
+	}
+
+	// Decides whether this process fills the shared table, reads it once
+	// published, or gives up on it. The legacy layout has no header, as
+	// older modules share it too, and keeps relying on map ownership.
+	REX::SharedRegion::Role IDDB::claim_table([[maybe_unused]] const std::size_t a_count, [[maybe_unused]] const std::chrono::milliseconds a_timeout)
+	{
+#ifdef COMMONLIB_OPTION_IDDB_LEGACY_LAYOUT
+		return m_mmap.is_owner() ? REX::SharedRegion::Role::Build : REX::SharedRegion::Role::Use;
+#else
+		REX::SharedRegion region(m_mmap.data(), TABLE_MAGIC, TABLE_LAYOUT);
+		return region.acquire(a_count * 2 * sizeof(std::uint32_t), a_timeout);
+#endif
+	}
+
+	// Stores ID-sorted mappings into the table created by map_table(). The
+	// compact layout requires them to pass fits_compact().
+	void IDDB::fill_table(std::span<const MAPPING> a_mappings)
+	{
+		const PHASE_TIMER timer(Phase::Map);
+
+#ifdef COMMONLIB_OPTION_IDDB_LEGACY_LAYOUT
+		if (a_mappings.data() != m_v0.data())
+			std::ranges::copy(a_mappings, m_v0.begin());
+#else
+		REX::SharedRegion region(m_mmap.data(), TABLE_MAGIC, TABLE_LAYOUT);
+		const auto        ids = reinterpret_cast<std::uint32_t*>(region.payload());
+		const auto        offsets = ids + a_mappings.size();
+		for (std::size_t i = 0; i < a_mappings.size(); ++i) {
+			const auto& mapping = a_mappings[i];
+			ids[i] = static_cast<std::uint32_t>(mapping.id);
+			offsets[i] = static_cast<std::uint32_t>(mapping.offset);
+		}
+
+		region.publish();
+#endif
+	}
+
+	// Serves lookups from sorted mappings this process decoded itself, for
+	// when the shared table could not be used.
+	void IDDB::keep_private(std::vector<MAPPING> a_mappings)
+	{
+		m_private = std::move(a_mappings);
+		m_table = TABLE{ m_private };
+	}
+
+	bool IDDB::unpack_file(STREAM& a_stream, const HEADER_V2& a_header, std::span<MAPPING> a_out)
+	{
+		std::vector<std::byte> buffer;
+		try {
+			buffer = a_stream.readall(DELTA_PADDING);
+		} catch (const std::bad_alloc&) {
+			REX::WARN("Failed to buffer Address Library file, falling back to stream decoding");
+			return unpack_stream(a_stream, a_header, a_out);
+		}
+
+		return unpack_buffer({ buffer.data(), buffer.size() - DELTA_PADDING }, a_header, a_out);
+	}
+
+	bool IDDB::unpack_buffer(std::span<const std::byte> a_data, const HEADER_V2& a_header, std::span<MAPPING> a_out)
+	{
+		const auto result = decode_buffer(a_data, a_header.pointer_size(), a_out);
+		if (result == DECODE::BadType)
+			REX::FAIL("Unhandled type while loading Address Library!");
+		if (result == DECODE::Truncated)
+			REX::FAIL(L"Failed to open Address Library file!\nPath: {}", m_path.wstring());
+
+		return result == DECODE::Ordered;
+	}
+
+	// Reads field by field; a truncated file ends in a system_error from
+	// the stream, reported by the caller.
+	bool IDDB::unpack_stream(STREAM& a_stream, const HEADER_V2& a_header, std::span<MAPPING> a_out)
+	{
+		const auto result = decode_fields(a_stream, a_header.pointer_size(), a_out);
+		if (result == DECODE::BadType)
+			REX::FAIL("Unhandled type while loading Address Library!");
+
+		return result == DECODE::Ordered;
+	}
+
+	void IDDB::sort(std::span<MAPPING> a_mappings, std::uint64_t MAPPING::* a_key)
+	{
+		// Stable LSD radix sort on 8-bit digits. Digits shared by every key are
+		// skipped, so typical ID ranges (< 2^24) take three passes.
+		constexpr std::size_t RADIX = 256;
+
+		const auto size = a_mappings.size();
+		if (size < 2)
+			return;
+
+		std::uint64_t varying = 0;
+		const auto    first = a_mappings[0].*a_key;
+		for (const auto& mapping : a_mappings)
+			varying |= mapping.*a_key ^ first;
+
+		const auto workers = REX::PARALLEL_WORKERS(size);
+		const auto chunk = (size + workers - 1) / workers;
+
+		std::vector<MAPPING>                         scratch(size);
+		std::vector<std::array<std::size_t, RADIX>> buckets(workers);
+
+		auto src = a_mappings.data();
+		auto dst = scratch.data();
+		for (std::size_t shift = 0; shift < 64; shift += 8) {
+			if (((varying >> shift) & 0xFF) == 0)
+				continue;
+
+			REX::PARALLEL_FOR(workers, [&](const std::size_t a_worker) {
+				auto& counts = buckets[a_worker];
+				counts.fill(0);
+
+				const auto last = std::min(size, (a_worker + 1) * chunk);
+				for (auto i = a_worker * chunk; i < last; ++i)
+					++counts[(src[i].*a_key >> shift) & 0xFF];
+			});
+
+			std::size_t total = 0;
+			for (std::size_t digit = 0; digit < RADIX; ++digit) {
+				for (auto& counts : buckets) {
+					const auto count = counts[digit];
+					counts[digit] = total;
+					total += count;
+				}
+			}
+
+			REX::PARALLEL_FOR(workers, [&](const std::size_t a_worker) {
+				auto& next = buckets[a_worker];
+
+				const auto last = std::min(size, (a_worker + 1) * chunk);
+				for (auto i = a_worker * chunk; i < last; ++i)
+					dst[next[(src[i].*a_key >> shift) & 0xFF]++] = src[i];
+			});
+
+			std::swap(src, dst);
+		}
+
+		if (src != a_mappings.data())
+			std::copy_n(src, size, a_mappings.data());
+	}
+
+	std::size_t IDDB::TABLE::lower_bound(const std::uint64_t a_id, const std::size_t a_first, const std::size_t a_last) const noexcept
+	{
+		if (m_mappings) {
+			const auto it = std::lower_bound(m_mappings + a_first, m_mappings + a_last, a_id, [](auto&& a_lhs, auto&& a_rhs) {
+				return a_lhs.id < a_rhs;
+			});
+			return static_cast<std::size_t>(it - m_mappings);
+		}
+
+		const auto it = std::lower_bound(m_ids + a_first, m_ids + a_last, a_id, [](auto&& a_lhs, auto&& a_rhs) {
+			return a_lhs < a_rhs;
+		});
+		return static_cast<std::size_t>(it - m_ids);
+	}
+
+	void IDDB::PRESENCE::reserve(const std::size_t a_count)
+	{
+		m_bits.clear();
+		m_ranks.clear();
+		m_count = a_count;
+		m_overflow = false;
+
+		// Cap the bitmap at 64 bits per entry, the size of a compact table
+		m_limit = std::max<std::uint64_t>(a_count * 64, 1 << 16);
+	}
+
+	void IDDB::PRESENCE::set(const std::uint64_t a_id)
+	{
+		if (a_id >= m_limit) {
+			m_overflow = true;
+			return;
+		}
+
+		const auto word = static_cast<std::size_t>(a_id / 64);
+		if (word >= m_bits.size())
+			m_bits.resize(word + 1);
+
+		m_bits[word] |= 1ull << (a_id % 64);
+	}
+
+	bool IDDB::PRESENCE::finish()
+	{
+		m_ranks.resize((m_bits.size() + WORDS_PER_RANK - 1) / WORDS_PER_RANK);
+
+		std::size_t total = 0;
+		for (std::size_t i = 0; i < m_bits.size(); ++i) {
+			if (i % WORDS_PER_RANK == 0)
+				m_ranks[i / WORDS_PER_RANK] = static_cast<std::uint32_t>(total);
+			total += static_cast<std::size_t>(std::popcount(m_bits[i]));
+		}
+
+		// Ranks are table positions only if every ID occurs exactly once
+		if (m_overflow || total != m_count || total > std::numeric_limits<std::uint32_t>::max()) {
+			m_bits = {};
+			m_ranks = {};
+			return false;
+		}
+
+		return true;
+	}
+
+	bool IDDB::PRESENCE::contains(const std::uint64_t a_id) const noexcept
+	{
+		const auto word = a_id / 64;
+		return word < m_bits.size() && (m_bits[static_cast<std::size_t>(word)] >> (a_id % 64) & 1) != 0;
+	}
+
+	std::size_t IDDB::PRESENCE::find(const std::uint64_t a_id) const noexcept
+	{
+		if (!contains(a_id))
+			return npos;
+
+		const auto word = static_cast<std::size_t>(a_id / 64);
+		auto       pos = static_cast<std::size_t>(m_ranks[word / WORDS_PER_RANK]);
+		for (auto i = word - word % WORDS_PER_RANK; i < word; ++i)
+			pos += static_cast<std::size_t>(std::popcount(m_bits[i]));
+
+		const auto below = m_bits[word] & ((1ull << (a_id % 64)) - 1);
+		return pos + static_cast<std::size_t>(std::popcount(below));
+	}
+
+	void IDDB::PROFILE::build(const std::span<const MAPPING> a_mappings)
+	{
+		if (a_mappings.empty())
+			return;
+
+		// At most half full, so misses end after a probe or two
+		const auto capacity = std::bit_ceil(a_mappings.size() * 2);
+		m_slots.assign(capacity, { EMPTY, 0 });
+		m_shift = static_cast<std::uint32_t>(64 - std::countr_zero(capacity));
+		for (const auto& mapping : a_mappings) {
+			auto i = slot(mapping.id);
+			while (m_slots[i].id != EMPTY)
+				i = (i + 1) & (capacity - 1);
+			m_slots[i] = mapping;
+		}
+
+		m_ready.store(true, std::memory_order_release);
+	}
+
+	std::optional<std::uint64_t> IDDB::PROFILE::find(const std::uint64_t a_id) const noexcept
+	{
+		if (!m_ready.load(std::memory_order_acquire))
+			return std::nullopt;
+
+		for (auto i = slot(a_id);; i = (i + 1) & (m_slots.size() - 1)) {
+			if (m_slots[i].id == a_id)
+				return m_slots[i].offset;
+			if (m_slots[i].id == EMPTY)
+				return std::nullopt;
+		}
+	}
+
+	IDDB::LAZY::~LAZY()
+	{
+		for (std::size_t i = 0; m_blocks && i < m_restarts.size(); ++i)
+			delete[] m_blocks[i].load(std::memory_order_relaxed);
+	}
+
+	bool IDDB::LAZY::build(std::vector<std::byte> a_data, const std::size_t a_count, const std::uint64_t a_pointerSize, PRESENCE& a_presence)
+	{
+		if (a_count == 0 || a_data.size() < DELTA_PADDING)
+			return false;
+
+		a_presence.reserve(a_count);
+
+		// One pass over the stream without storing anything but the state
+		// needed to resume decoding at the start of every block
+		std::vector<RESTART> restarts;
+		restarts.reserve((a_count + BLOCK - 1) / BLOCK);
+
+		const auto last = a_data.data() + a_data.size() - DELTA_PADDING;
+		auto       cursor = std::as_const(a_data).data();
+		MAPPING    prev{ 0, 0 };
+		for (std::size_t i = 0; i < a_count; ++i) {
+			const auto pos = static_cast<std::size_t>(cursor - a_data.data());
+			MAPPING    mapping;
+			if (!decode_mapping(cursor, prev, a_pointerSize, mapping) || cursor > last || mapping.id < prev.id)
+				return false;
+
+			if (i % BLOCK == 0)
+				restarts.push_back({ pos, prev, mapping.id });
+
+			a_presence.set(mapping.id);
+			prev = mapping;
+		}
+
+		a_presence.finish();
+
+		m_data = std::move(a_data);
+		m_restarts = std::move(restarts);
+		m_count = a_count;
+		m_pointerSize = a_pointerSize;
+		m_blocks = std::make_unique<std::atomic<MAPPING*>[]>(m_restarts.size());
+		return true;
+	}
+
+	const IDDB::MAPPING* IDDB::LAZY::block(const std::size_t a_block) const
+	{
+		auto& slot = m_blocks[a_block];
+		if (const auto mappings = slot.load(std::memory_order_acquire))
+			return mappings;
+
+		const auto& restart = m_restarts[a_block];
+		const auto  size = block_size(a_block);
+
+		auto    mappings = std::make_unique<MAPPING[]>(size);
+		auto    cursor = std::as_const(m_data).data() + restart.pos;
+		MAPPING prev = restart.prev;
+		for (std::size_t i = 0; i < size; ++i) {
+			// Every block was decoded once by build(), so the types are valid
+			decode_mapping(cursor, prev, m_pointerSize, mappings[i]);
+			prev = mappings[i];
+		}
+
+		// Threads racing on the same block decode it redundantly; one wins
+		MAPPING* expected = nullptr;
+		if (slot.compare_exchange_strong(expected, mappings.get(), std::memory_order_acq_rel))
+			return mappings.release();
+
+		return expected;
+	}
+
+	const IDDB::MAPPING* IDDB::LAZY::lower_bound(const std::uint64_t a_id) const
+	{
+		if (empty())
+			return nullptr;
+
+		// The first ID not below `a_id` lies in the last block starting
+		// below it, or else opens the block after that one
+		const auto next = std::lower_bound(m_restarts.begin(), m_restarts.end(), a_id, [](auto&& a_lhs, auto&& a_rhs) {
+			return a_lhs.firstID < a_rhs;
+		});
+		if (next == m_restarts.begin())
+			return block(0);
+
+		const auto idx = static_cast<std::size_t>(next - m_restarts.begin()) - 1;
+		const auto first = block(idx);
+		const auto last = first + block_size(idx);
+		const auto it = std::lower_bound(first, last, a_id, [](auto&& a_lhs, auto&& a_rhs) {
+			return a_lhs.id < a_rhs;
+		});
+
+		if (it != last)
+			return it;
+
+		return idx + 1 < m_restarts.size() ? block(idx + 1) : nullptr;
+	}
+
+	void IDDB::LAZY::offsets(std::span<const MAPPING> a_requests, std::span<std::uint64_t> a_out, std::vector<std::uint64_t>& a_missing) const
+	{
+		if (empty())
+			return;
+
+		// The requests are sorted, so the block and the position within it
+		// only ever move forward
+		std::size_t    idx = 0;
+		const MAPPING* cursor = nullptr;
+		const MAPPING* last = nullptr;
+		for (const auto& request : a_requests) {
+			while (idx + 1 < m_restarts.size() && m_restarts[idx + 1].firstID <= request.id) {
+				++idx;
+				cursor = nullptr;
+			}
+
+			if (m_restarts[idx].firstID <= request.id) {
+				if (!cursor) {
+					cursor = block(idx);
+					last = cursor + block_size(idx);
+				}
+				cursor = std::lower_bound(cursor, last, request.id, [](auto&& a_lhs, auto&& a_rhs) {
+					return a_lhs.id < a_rhs;
+				});
+				if (cursor != last && cursor->id == request.id) {
+					a_out[request.offset] = cursor->offset;
+					continue;
+				}
+			}
+
+			a_out[request.offset] = 0;
+			if (a_missing.empty() || a_missing.back() != request.id)
+				a_missing.push_back(request.id);
+		}
+	}
+
+	std::span<IDDB::MAPPING> IDDB::LAZY::materialize() const
+	{
+		std::call_once(m_materialized, [this]() {
+			m_all.resize(m_count);
+			for (std::size_t i = 0; i < m_restarts.size(); ++i)
+				std::copy_n(block(i), block_size(i), m_all.begin() + i * BLOCK);
+		});
+
+		return m_all;
+	}
+
+	bool IDDB::load_cache()
+	{
+		const PHASE_TIMER timer(Phase::Open);
+
+		const auto identity = file_identity(m_path);
+		if (!identity)
+			return false;
+
+		const auto      path = cache_path(m_path);
+		std::error_code ec;
+		if (!std::filesystem::exists(path, ec))
+			return false;
+
+		const auto mod = detail::ModuleBase::GetSingleton();
+		const auto mapName = std::format("COMMONLIB_IDDB_CACHE_{:016X}", REX::FNV1A_64(std::as_bytes(std::span{ std::addressof(*identity), 1 })));
+
+		// Probed in its own map so a stale cache leaves m_mmap untouched for
+		// the regular load
+		REX::MemoryMap cache;
+		if (!cache.create(false, path, mapName))
+			return false;
+
+		CACHE_HEADER header;
+		if (cache.size() >= sizeof(header))
+			std::memcpy(&header, cache.data(), sizeof(header));
+
+		const auto payload = std::span{ cache.data(), cache.size() }.subspan(std::min(cache.size(), sizeof(header)));
+		const auto version = mod->version();
+		const bool valid =
+			header.magic == CACHE_HEADER::MAGIC &&
+			header.layout == CACHE_HEADER::LAYOUT &&
+			std::ranges::equal(header.gameVersion, version) &&
+			header.source == *identity &&
+			header.count > 0 &&
+			payload.size() == header.count * sizeof(MAPPING) &&
+			REX::FNV1A_64(payload) == header.checksum;
+
+		if (!valid) {
+			REX::DEBUG(L"Address Library cache is stale: {}", path.wstring());
+			return false;
+		}
+
+		// A hit never maps the source, so the blacklist check maps it here;
+		// its digest is cached, so only a changed file is hashed again
+		REX::MemoryMap source;
+		const auto     sourceName = std::format("COMMONLIB_IDDB_SOURCE_{}", version.string("_"));
+		if (!source.create(false, m_path, sourceName))
+			return false;
+
+		validate_file(source);
+
+		m_mmap = std::move(cache);
+		m_format = static_cast<Format>(header.format);
+		m_v0 = { reinterpret_cast<MAPPING*>(payload.data()), static_cast<std::size_t>(header.count) };
+		m_table = TABLE{ m_v0 };
+		return true;
+	}
+
+	void IDDB::write_cache(std::span<const MAPPING> a_mappings) const
+	{
+		const auto identity = file_identity(m_path);
+		if (!identity)
+			return;
+
+		const auto mod = detail::ModuleBase::GetSingleton();
+		const auto version = mod->version();
+		const auto payload = std::as_bytes(a_mappings);
+
+		CACHE_HEADER header;
+		header.format = std::to_underlying(m_format);
+		std::ranges::copy(version, header.gameVersion);
+		header.source = *identity;
+		header.count = a_mappings.size();
+		header.checksum = REX::FNV1A_64(payload);
+
+		// Write to a temporary file first so a concurrent reader never sees a
+		// partial cache; losing the race to another writer is harmless.
+		const auto path = cache_path(m_path);
+		auto       temp = path;
+		temp += std::format(L".{}", REX::W32::GetCurrentProcessId());
+		{
+			std::ofstream file(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+			if (!file) {
+				REX::WARN(L"Failed to write Address Library cache: {}", temp.wstring());
+				std::error_code ec;
+				std::filesystem::remove(temp, ec);
+				return;
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(temp, path, ec);
+		if (ec) {
+			REX::DEBUG(L"Failed to replace Address Library cache: {}", path.wstring());
+			std::filesystem::remove(temp, ec);
+		}
+	}
+
+#ifdef COMMONLIB_OPTION_IDDB_MANIFEST
+	void IDDB::preload()
+	{
+		std::ifstream file(m_manifest, std::ios::in | std::ios::binary);
+		if (!file)
+			return;
+
+		MANIFEST_HEADER header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		// A manifest of another game version or runtime lists the wrong IDs
+		const auto mod = detail::ModuleBase::GetSingleton();
+		const auto version = mod->version();
+		if (!file || header.magic != MANIFEST_HEADER::MAGIC || header.layout != MANIFEST_HEADER::LAYOUT ||
+			header.runtime != detail::get_runtime_index() || !std::ranges::equal(version, header.gameVersion) ||
+			header.size > (1 << 24) || header.count > header.size) {
+			REX::DEBUG(L"Ignoring stale Address Library manifest: {}", m_manifest.wstring());
+			return;
+		}
+
+		std::vector<std::byte> payload(static_cast<std::size_t>(header.size));
+		file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+		if (!file || REX::FNV1A_64(payload) != header.checksum) {
+			REX::DEBUG(L"Ignoring corrupt Address Library manifest: {}", m_manifest.wstring());
+			return;
+		}
+
+		std::vector<std::uint64_t> ids;
+		ids.reserve(static_cast<std::size_t>(header.count));
+		std::uint64_t id = 0;
+		for (std::size_t pos = 0; pos < payload.size();) {
+			std::uint64_t delta = 0;
+			for (std::uint32_t shift = 0; pos < payload.size() && shift < 64; shift += 7) {
+				const auto byte = static_cast<std::uint64_t>(payload[pos++]);
+				delta |= (byte & 0x7F) << shift;
+				if (!(byte & 0x80))
 					break;
-				default:
-					REX::FAIL("Unhandled type while loading Address Library!");
 			}
+			ids.push_back(id += delta);
+		}
+
+		// Resolve off the loading thread; lookups until then take the regular path
+		m_preload = std::jthread([this, ids = std::move(ids)]() {
+			std::vector<MAPPING> resolved;
+			resolved.reserve(ids.size());
+			for (const auto id : ids) {
+				if (const auto offset = lookup(id))
+					resolved.push_back({ id, *offset });
+			}
+
+			m_profile.build(resolved);
+			REX::DEBUG("Pre-resolved {} of {} Address Library IDs", resolved.size(), ids.size());
+		});
+	}
 
-			if ((hi & 8) != 0) {
-				offset *= a_header.pointer_size();
+	void IDDB::write_manifest() const
+	{
+		auto&                  global = global_manifest();
+		const std::scoped_lock writeLock(global.writeLock);
+
+		std::vector<std::uint64_t> ids;
+		{
+			const std::scoped_lock lock(global.lock);
+			for (const auto& thread : global.threads) {
+				const std::scoped_lock threadLock(thread->lock);
+				ids.insert(ids.end(), thread->ids.begin(), thread->ids.end());
 			}
+		}
+
+		std::ranges::sort(ids);
+		ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+		// Recorded IDs are never dropped, so the same count means the same set
+		if (ids.size() == global.written)
+			return;
 
-			mapping = { id, offset };
+		std::vector<std::byte> payload;
+		payload.reserve(ids.size() * 2);
+		std::uint64_t prev = 0;
+		for (const auto id : ids) {
+			auto delta = id - prev;
+			for (; delta >= 0x80; delta >>= 7)
+				payload.push_back(static_cast<std::byte>(delta | 0x80));
+			payload.push_back(static_cast<std::byte>(delta));
+			prev = id;
+		}
+
+		const auto mod = detail::ModuleBase::GetSingleton();
+		const auto version = mod->version();
+
+		MANIFEST_HEADER header;
+		header.runtime = static_cast<std::uint32_t>(detail::get_runtime_index());
+		std::ranges::copy(version, header.gameVersion);
+		header.count = ids.size();
+		header.size = payload.size();
+		header.checksum = REX::FNV1A_64(payload);
+
+		// Replaced in one step so the next launch never reads a partial file
+		auto temp = m_manifest;
+		temp += L".tmp";
+		{
+			std::ofstream file(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+			if (!file) {
+				REX::WARN(L"Failed to write Address Library manifest: {}", temp.wstring());
+				std::error_code ec;
+				std::filesystem::remove(temp, ec);
+				return;
+			}
+		}
 
-			prevOffset = offset;
-			prevID = id;
+		std::error_code ec;
+		std::filesystem::rename(temp, m_manifest, ec);
+		if (ec) {
+			REX::DEBUG(L"Failed to replace Address Library manifest: {}", m_manifest.wstring());
+			std::filesystem::remove(temp, ec);
+			return;
 		}
+
+		global.written = ids.size();
+	}
+#endif
+
+	void IDDB::flush() const
+	{
+#ifdef COMMONLIB_OPTION_IDDB_MANIFEST
+		write_manifest();
+#endif
 	}
 
-	void IDDB::validate_file()
+	void IDDB::validate_file(const REX::MemoryMap& a_file)
 	{
+		const PHASE_TIMER timer(Phase::Validate);
+
 		// clang-format off
-		std::unordered_map<IDDB::Loader, std::vector<std::pair<REL::Version, std::string_view>>> g_blacklistMap{
+		std::unordered_map<IDDB::Loader, std::vector<std::pair<REL::Version, REX::SHA512_DIGEST>>> g_blacklistMap{
 			{ IDDB::Loader::SKSE, {} },
 			{ IDDB::Loader::F4SE, { 
-				{ REL::Version{ 1, 10, 980 }, "2AD60B95388F1B6E77A6F86F17BEB51D043CF95A341E91ECB2E911A393E45FE8156D585D2562F7B14434483D6E6652E2373B91589013507CABAE596C26A343F1"sv },
-				{ REL::Version{ 1, 11, 159 }, "686D40387F638ED75AD43BB76CA14170576F1A30E91144F280987D13A3012B1CA6A4E04E6BE7A5B99E46C50332C49BE40C3D9448038E17D3D31C40E72A90AE26"sv }
+				{ REL::Version{ 1, 10, 980 }, parse_digest("2AD60B95388F1B6E77A6F86F17BEB51D043CF95A341E91ECB2E911A393E45FE8156D585D2562F7B14434483D6E6652E2373B91589013507CABAE596C26A343F1") },
+				{ REL::Version{ 1, 11, 159 }, parse_digest("686D40387F638ED75AD43BB76CA14170576F1A30E91144F280987D13A3012B1CA6A4E04E6BE7A5B99E46C50332C49BE40C3D9448038E17D3D31C40E72A90AE26") }
 			} },
 			{ IDDB::Loader::SFSE, {} },
 			{ IDDB::Loader::OBSE, {} },
 		};
 		// clang-format on
 
-		const auto mod = Module::GetSingleton();
+		const auto mod = detail::ModuleBase::GetSingleton();
 		const auto version = mod->version();
 		for (auto& check : g_blacklistMap[m_loader]) {
 			if (version == check.first) {
-				auto sha = REX::SHA512({ m_mmap.data(), m_mmap.size() });
+				// Only a mapping of the file itself can be keyed by its identity
+				const std::span data{ a_file.data(), a_file.size() };
+				const auto      sha = a_file.is_file() ? cached_digest(m_path, data) : REX::SHA512_RAW(data);
 				if (!sha)
 					REX::FAIL("Failed to hash Address Library file!\nPath: {}", m_path.string());
 				if (*sha == check.second)
@@ -517,35 +1661,47 @@ namespace REL
 
 	std::uint64_t IDDB::offset(std::uint64_t a_id) const
 	{
+#ifdef COMMONLIB_OPTION_IDDB_MANIFEST
+		if (const auto offset = m_profile.find(a_id)) {
+			record_lookup(a_id, true);
+			return *offset;
+		}
+#endif
+
 		const auto mod = detail::ModuleBase::GetSingleton();
 		if (std::to_underlying(m_format) < 5) {
-			if (m_v0.empty())
+			if (!m_lazy.empty()) {
+				if (const auto mapping = m_lazy.lower_bound(a_id)) {
+					record_lookup(a_id, mapping->id == a_id);
+					return mapping->offset;
+				}
+			} else if (m_table.empty()) {
 				REX::FAIL("No Address Library has been loaded!");
-
-			const MAPPING elem{ a_id, 0 };
-			const auto    it = std::lower_bound(
-                m_v0.begin(),
-                m_v0.end(),
-                elem,
-                [](auto&& a_lhs, auto&& a_rhs) {
-                    return a_lhs.id < a_rhs.id;
-                });
-
-			if (it == m_v0.end()) {
-				REX::FAIL(
-					"Failed to find offset for Address Library ID!\n"
-					"Invalid ID: {}\n"
-					"Game Version: {}",
-					a_id, mod->version().string());
+			} else if (!m_index.empty()) {
+				if (const auto pos = m_index.lower_bound(a_id); pos != INDEX::npos) {
+					record_lookup(a_id, m_index.id(pos) == a_id);
+					return m_index.offset(pos);
+				}
+			} else {
+				if (const auto pos = m_table.lower_bound(a_id, 0, m_table.size()); pos != m_table.size()) {
+					record_lookup(a_id, m_table.id(pos) == a_id);
+					return m_table.offset(pos);
+				}
 			}
 
-			return static_cast<std::size_t>(it->offset);
+			record_lookup(a_id, false);
+			REX::FAIL(
+				"Failed to find offset for Address Library ID!\n"
+				"Invalid ID: {}\n"
+				"Game Version: {}",
+				a_id, mod->version().string());
 		}
 
 		if (m_v5.empty())
 			REX::FAIL("No Address Library has been loaded!");
 
 		const auto offset = static_cast<std::uint64_t>(m_v5[a_id]);
+		record_lookup(a_id, offset != 0);
 		if (!offset) {
 			REX::FAIL(
 				"Failed to find offset for Address Library ID!\n"
@@ -556,4 +1712,163 @@ namespace REL
 
 		return offset;
 	}
+
+	std::optional<std::uint64_t> IDDB::try_offset(const std::uint64_t a_id) const
+	{
+#ifdef COMMONLIB_OPTION_IDDB_MANIFEST
+		if (const auto offset = m_profile.find(a_id)) {
+			record_lookup(a_id, true);
+			return offset;
+		}
+#endif
+
+		const auto result = lookup(a_id);
+		record_lookup(a_id, result.has_value());
+		return result;
+	}
+
+	std::optional<std::uint64_t> IDDB::lookup(const std::uint64_t a_id) const
+	{
+		if (std::to_underlying(m_format) >= 5) {
+			if (a_id < m_v5.size() && m_v5[a_id] != 0)
+				return m_v5[a_id];
+		} else if (!m_presence.empty()) {
+			if (const auto pos = m_presence.find(a_id); pos != PRESENCE::npos)
+				return m_lazy.empty() ? m_table.offset(pos) : m_lazy.at(pos).offset;
+		} else if (!m_lazy.empty()) {
+			if (const auto mapping = m_lazy.lower_bound(a_id); mapping && mapping->id == a_id)
+				return mapping->offset;
+		} else if (!m_index.empty()) {
+			if (const auto pos = m_index.lower_bound(a_id); pos != INDEX::npos && m_index.id(pos) == a_id)
+				return m_index.offset(pos);
+		} else if (!m_table.empty()) {
+			if (const auto pos = m_table.lower_bound(a_id, 0, m_table.size()); pos != m_table.size() && m_table.id(pos) == a_id)
+				return m_table.offset(pos);
+		}
+
+		return std::nullopt;
+	}
+
+	bool IDDB::contains(const std::uint64_t a_id) const
+	{
+		if (std::to_underlying(m_format) >= 5)
+			return a_id < m_v5.size() && m_v5[a_id] != 0;
+
+		if (!m_presence.empty())
+			return m_presence.contains(a_id);
+
+		return try_offset(a_id).has_value();
+	}
+
+	void IDDB::offsets(std::span<const std::uint64_t> a_ids, std::span<std::uint64_t> a_out) const
+	{
+		if (a_out.size() < a_ids.size())
+			REX::FAIL("Address Library batch output is smaller than its input!");
+
+		std::vector<std::uint64_t> missing;
+		if (!m_lazy.empty()) {
+			// Resolve in ID order so each block is decoded and visited once
+			std::vector<MAPPING> requests(a_ids.size());
+			for (std::size_t i = 0; i < a_ids.size(); ++i)
+				requests[i] = { a_ids[i], i };
+			sort(requests, &MAPPING::id);
+
+			m_lazy.offsets(requests, a_out, missing);
+		} else if (std::to_underlying(m_format) < 5) {
+			if (m_table.empty())
+				REX::FAIL("No Address Library has been loaded!");
+
+			// Resolve in ID order so the table is swept once, front to back
+			std::vector<MAPPING> requests(a_ids.size());
+			for (std::size_t i = 0; i < a_ids.size(); ++i)
+				requests[i] = { a_ids[i], i };
+			sort(requests, &MAPPING::id);
+
+			const auto  size = m_table.size();
+			std::size_t pos = 0;
+			for (const auto& request : requests) {
+				// Gallop forward from the previous hit, then search the bracket
+				std::size_t step = 1;
+				while (step < size - pos && m_table.id(pos + step) < request.id) {
+					pos += step;
+					step *= 2;
+				}
+
+				pos = m_table.lower_bound(request.id, pos, pos + std::min(step + 1, size - pos));
+				if (pos != size && m_table.id(pos) == request.id) {
+					a_out[request.offset] = m_table.offset(pos);
+				} else {
+					a_out[request.offset] = 0;
+					if (missing.empty() || missing.back() != request.id)
+						missing.push_back(request.id);
+				}
+			}
+		} else {
+			if (m_v5.empty())
+				REX::FAIL("No Address Library has been loaded!");
+
+			for (std::size_t i = 0; i < a_ids.size(); ++i) {
+				a_out[i] = a_ids[i] < m_v5.size() ? m_v5[a_ids[i]] : 0;
+				if (!a_out[i])
+					missing.push_back(a_ids[i]);
+			}
+		}
+
+		for (std::size_t i = 0; i < a_ids.size(); ++i)
+			record_lookup(a_ids[i], a_out[i] != 0);
+
+		if (!missing.empty()) {
+			std::string list;
+			for (const auto id : missing)
+				list += std::format("{}{}", list.empty() ? "" : ", ", id);
+
+			const auto mod = detail::ModuleBase::GetSingleton();
+			REX::FAIL(
+				"Failed to find offsets for {} Address Library IDs!\n"
+				"Invalid IDs: {}\n"
+				"Game Version: {}",
+				missing.size(), list, mod->version().string());
+		}
+	}
+
+	IDDB::STATS IDDB::stats([[maybe_unused]] const std::size_t a_top) const
+	{
+		STATS result;
+#ifdef COMMONLIB_OPTION_IDDB_STATS
+		auto& global = global_stats();
+		result.enabled = true;
+		for (std::size_t i = 0; i < STATS::PHASE_COUNT; ++i)
+			result.phases[i] = std::chrono::nanoseconds(global.phases[i].load(std::memory_order_relaxed));
+
+		std::unordered_map<std::uint64_t, std::uint64_t> ids;
+		{
+			const std::scoped_lock lock(global.lock);
+			for (const auto& thread : global.threads) {
+				const std::scoped_lock threadLock(thread->lock);
+				result.lookups += thread->lookups;
+				result.misses += thread->misses;
+				for (const auto& [id, count] : thread->ids)
+					ids[id] += count;
+			}
+		}
+
+		result.top.assign(ids.begin(), ids.end());
+		const auto top = std::min(a_top, result.top.size());
+		std::partial_sort(result.top.begin(), result.top.begin() + top, result.top.end(), [](auto&& a_lhs, auto&& a_rhs) {
+			return a_lhs.second != a_rhs.second ? a_lhs.second > a_rhs.second : a_lhs.first < a_rhs.first;
+		});
+		result.top.resize(top);
+#endif
+		return result;
+	}
+
+	void IDDB::addresses(std::span<const std::uint64_t> a_ids, std::span<std::uintptr_t> a_out) const
+	{
+		static_assert(sizeof(std::uintptr_t) == sizeof(std::uint64_t));
+		offsets(a_ids, { reinterpret_cast<std::uint64_t*>(a_out.data()), a_out.size() });
+
+		const auto base = detail::ModuleBase::GetSingleton()->base();
+		for (std::size_t i = 0; i < a_ids.size(); ++i)
+			a_out[i] += base;
+	}
 }
@@ -1,18 +1,58 @@
 #include "REL/Offset2ID.h"
 
 #include "REL/Module.h"
+#include "REX/REX/CAST.h"
 #include "REX/REX/LOG.h"
+#include "REX/W32/KERNEL32.h"
 
 namespace REL
 {
+	namespace
+	{
+		// Header of the shared offset-sorted table
+		constexpr std::uint64_t TABLE_MAGIC{ 0x44493246464F4C43 };  // "CLOFF2ID"
+		constexpr std::uint32_t TABLE_LAYOUT{ 1 };
+
+		// How long to wait for another module to publish the table before
+		// building a private copy instead
+		constexpr std::chrono::milliseconds TABLE_TIMEOUT{ 5000 };
+
+		// Unwind info flag marking a function fragment whose unwind data
+		// continues in the RUNTIME_FUNCTION that follows its unwind codes
+		constexpr std::uint8_t UNW_FLAG_CHAININFO{ 0x4 };
+
+		// Follows the unwind chain of a fragment to its primary function.
+		std::uint32_t primary_function(const std::uintptr_t a_base, const REX::W32::IMAGE_RUNTIME_FUNCTION_ENTRY& a_entry) noexcept
+		{
+			auto entry = &a_entry;
+			for (std::size_t depth = 0; depth < 32; ++depth) {
+				// An odd unwind address points straight at another entry
+				if (entry->unwindInfoAddress & 1) {
+					entry = reinterpret_cast<const REX::W32::IMAGE_RUNTIME_FUNCTION_ENTRY*>(a_base + (entry->unwindInfoAddress & ~1u));
+					continue;
+				}
+
+				const auto info = reinterpret_cast<const std::uint8_t*>(a_base + entry->unwindInfoAddress);
+				if (!((info[0] >> 3) & UNW_FLAG_CHAININFO))
+					break;
+
+				// Unwind codes are 2 bytes each, padded to an even count
+				const std::size_t codes = (info[2] + 1u) & ~1u;
+				entry = reinterpret_cast<const REX::W32::IMAGE_RUNTIME_FUNCTION_ENTRY*>(info + 4 + codes * 2);
+			}
+
+			return entry->beginAddress;
+		}
+	}
+
 	void Offset2ID::load_v2()
 	{
 		const auto iddb = IDDB::GetSingleton();
-		const auto id2offset = iddb->get_id2offset<IDDB::MAPPING>();
-		_offset2id.reserve(id2offset.size());
-		_offset2id.insert(_offset2id.begin(), id2offset.begin(), id2offset.end());
-		std::sort(std::execution::sequenced_policy{}, _offset2id.begin(), _offset2id.end(), [](auto&& a_lhs, auto&& a_rhs) {
-			return a_lhs.offset < a_rhs.offset;
+		load(iddb->get_table_size(), [&](std::span<value_type> a_out) {
+			const auto table = iddb->get_table();
+			for (std::size_t i = 0; i < table.size(); ++i) {
+				a_out[i] = { table.id(i), table.offset(i) };
+			}
 		});
 	}
 
@@ -20,15 +60,170 @@ namespace REL
 	{
 		const auto iddb = IDDB::GetSingleton();
 		const auto id2offset = iddb->get_id2offset<std::uint32_t>();
-		_offset2id.reserve(id2offset.size());
+		load(id2offset.size(), [&](std::span<value_type> a_out) {
+			for (std::size_t i = 0; i < id2offset.size(); ++i) {
+				a_out[i] = { i, id2offset[i] };
+			}
+		});
+	}
+
+	void Offset2ID::load(const std::size_t a_count, const std::function<void(std::span<value_type>)>& a_fill)
+	{
+		_offset2id = {};
+		_private = {};
+		_mmap.close();
+
+		const auto mod = detail::ModuleBase::GetSingleton();
+		const auto mapName = std::format("COMMONLIB_OFFSET2ID_{}", mod->version().string("_"));
+		if (_mmap.create(true, mapName, sizeof(REX::SharedRegion::HEADER) + a_count * sizeof(value_type))) {
+			REX::SharedRegion region(_mmap.data(), TABLE_MAGIC, TABLE_LAYOUT);
+			const std::span   mappings{ reinterpret_cast<value_type*>(region.payload()), a_count };
+			switch (region.acquire(a_count * sizeof(value_type), TABLE_TIMEOUT)) {
+				case REX::SharedRegion::Role::Use:
+					_offset2id = mappings;
+					return;
+				case REX::SharedRegion::Role::Build:
+					a_fill(mappings);
+					IDDB::sort(mappings, &value_type::offset);
+					region.publish();
+					_offset2id = mappings;
+					return;
+				case REX::SharedRegion::Role::Fallback:
+					break;
+			}
+
+			_mmap.close();
+		}
+
+		REX::WARN("Shared Offset2ID table is unavailable, building a private copy");
+		_private.resize(a_count);
+		a_fill(_private);
+		IDDB::sort(_private, &value_type::offset);
+		_offset2id = _private;
+	}
+
+	std::optional<Offset2ID::LOCATION> Offset2ID::get_location(const std::size_t a_offset) const
+	{
+		std::call_once(_functionsBuilt, [this]() { build_functions(); });
+
+		const auto function = std::upper_bound(_functions.begin(), _functions.end(), a_offset, [](auto&& a_lhs, auto&& a_rhs) {
+			return a_lhs < a_rhs.begin;
+		});
+		return locate(a_offset, function, upper_bound(a_offset));
+	}
+
+	std::vector<Offset2ID::SYMBOL> Offset2ID::symbolize(const std::span<const std::uintptr_t> a_addresses) const
+	{
+		std::vector<SYMBOL> result(a_addresses.size());
+		if (a_addresses.empty())
+			return result;
 
-		std::uint64_t id{ 0 };
-		for (auto offset : id2offset) {
-			_offset2id.emplace(_offset2id.end(), value_type{ id++, offset });
+		const auto mod = detail::ModuleBase::GetSingleton();
+		const auto base = mod->base();
+		const auto dosHeader = reinterpret_cast<const REX::W32::IMAGE_DOS_HEADER*>(base);
+		const auto ntHeader = REX::ADJUST_POINTER<REX::W32::IMAGE_NT_HEADERS64>(dosHeader, dosHeader->lfanew);
+		const auto imageSize = static_cast<std::size_t>(ntHeader->optionalHeader.imageSize);
+
+		std::call_once(_functionsBuilt, [this]() { build_functions(); });
+
+		// Visit the queries in address order so both tables are walked once
+		std::vector<std::size_t> order;
+		order.reserve(a_addresses.size());
+		for (std::size_t i = 0; i < a_addresses.size(); ++i) {
+			result[i].address = a_addresses[i];
+			if (a_addresses[i] >= base && a_addresses[i] - base < imageSize) {
+				result[i].offset = a_addresses[i] - base;
+				order.push_back(i);
+			}
+		}
+		std::ranges::sort(order, {}, [&](std::size_t a_index) { return result[a_index].offset; });
+
+		auto function = _functions.begin();
+		auto mapping = _offset2id.begin();
+		for (const auto index : order) {
+			auto&      symbol = result[index];
+			const auto offset = symbol.offset;
+			while (function != _functions.end() && function->begin <= offset)
+				++function;
+			while (mapping != _offset2id.end() && mapping->offset <= offset)
+				++mapping;
+
+			if (const auto location = locate(offset, function, mapping)) {
+				symbol.status = SYMBOL::Status::Resolved;
+				symbol.location = *location;
+			} else {
+				symbol.status = SYMBOL::Status::NoID;
+			}
+		}
+
+		return result;
+	}
+
+	std::optional<Offset2ID::LOCATION> Offset2ID::locate(const std::size_t a_offset, const function_iterator a_function, const const_iterator a_mapping) const noexcept
+	{
+		if (a_function != _functions.begin()) {
+			// A chained fragment can lie before its primary function; the
+			// displacement would be negative, so use the nearest ID instead
+			const auto& candidate = *std::prev(a_function);
+			if (a_offset < candidate.end && a_offset >= candidate.primary && candidate.id != FUNCTION::npos)
+				return LOCATION{ candidate.id, a_offset - candidate.primary, true };
+		}
+
+		if (a_mapping == _offset2id.begin())
+			return std::nullopt;
+
+		const auto& mapping = *std::prev(a_mapping);
+		return LOCATION{ mapping.id, a_offset - static_cast<std::size_t>(mapping.offset), false };
+	}
+
+	// Pairs every .pdata function with the ID at the start of its primary
+	// function in one merge, as both lists are sorted by address.
+	void Offset2ID::build_functions() const
+	{
+		const auto mod = detail::ModuleBase::GetSingleton();
+		const auto pdata = mod->segment(Segment::pdata);
+		const auto entries = std::span{
+			pdata.pointer<const REX::W32::IMAGE_RUNTIME_FUNCTION_ENTRY>(),
+			pdata.size() / sizeof(REX::W32::IMAGE_RUNTIME_FUNCTION_ENTRY)
+		};
+
+		_functions.reserve(entries.size());
+		for (const auto& entry : entries) {
+			if (entry.beginAddress == 0 || entry.endAddress <= entry.beginAddress)
+				continue;
+
+			_functions.push_back({ entry.beginAddress, entry.endAddress, primary_function(mod->base(), entry), FUNCTION::npos });
 		}
 
-		std::sort(std::execution::sequenced_policy{}, _offset2id.begin(), _offset2id.end(), [](auto&& a_lhs, auto&& a_rhs) {
-			return a_lhs.offset < a_rhs.offset;
+		std::vector<std::uint32_t> starts(_functions.size());
+		for (std::size_t i = 0; i < _functions.size(); ++i)
+			starts[i] = _functions[i].primary;
+		std::ranges::sort(starts);
+		starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+		// ID at each distinct primary start, or npos
+		std::vector<std::uint64_t> ids(starts.size(), FUNCTION::npos);
+		auto                       it = _offset2id.begin();
+		for (std::size_t i = 0; i < starts.size(); ++i) {
+			while (it != _offset2id.end() && it->offset < starts[i])
+				++it;
+			if (it != _offset2id.end() && it->offset == starts[i])
+				ids[i] = it->id;
+		}
+
+		for (auto& function : _functions) {
+			const auto pos = std::ranges::lower_bound(starts, function.primary) - starts.begin();
+			function.id = ids[static_cast<std::size_t>(pos)];
+		}
+
+		// .pdata is sorted by address, but do not rely on it for the search
+		std::ranges::sort(_functions, {}, &FUNCTION::begin);
+	}
+
+	Offset2ID::const_iterator Offset2ID::upper_bound(const std::size_t a_offset) const noexcept
+	{
+		return std::upper_bound(_offset2id.begin(), _offset2id.end(), a_offset, [](auto&& a_lhs, auto&& a_rhs) {
+			return a_lhs < a_rhs.offset;
 		});
 	}
 
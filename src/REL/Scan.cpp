@@ -0,0 +1,430 @@
+#include "REL/Scan.h"
+
+#include "REX/REX/CAST.h"
+#include "REX/REX/HASH.h"
+#include "REX/REX/LOG.h"
+#include "REX/REX/Parallel.h"
+#include "REX/W32/KERNEL32.h"
+
+namespace REL
+{
+	namespace detail
+	{
+#ifdef COMMONLIB_OPTION_SCAN_CACHE
+		namespace
+		{
+			// Identifies the game executable without hashing all of it
+			struct MODULE_IDENTITY
+			{
+				std::uint32_t timestamp{ 0 };
+				std::uint32_t pad{ 0 };
+				std::uint64_t textSize{ 0 };
+				std::uint64_t sample{ 0 };
+
+				bool operator==(const MODULE_IDENTITY&) const = default;
+			};
+
+			MODULE_IDENTITY module_identity()
+			{
+				// Spread over the whole segment, so a patch anywhere in it
+				// is likely to change at least one sample
+				constexpr std::size_t SAMPLES{ 256 };
+				constexpr std::size_t SAMPLE_SIZE{ 64 };
+
+				const auto mod = ModuleBase::GetSingleton();
+				const auto dosHeader = reinterpret_cast<const REX::W32::IMAGE_DOS_HEADER*>(mod->base());
+				const auto ntHeader = REX::ADJUST_POINTER<REX::W32::IMAGE_NT_HEADERS64>(dosHeader, dosHeader->lfanew);
+				const auto text = mod->segment(Segment::text);
+				const auto data = std::span{ text.pointer<const std::byte>(), text.size() };
+
+				MODULE_IDENTITY result;
+				result.timestamp = ntHeader->fileHeader.timeDateStamp;
+				result.textSize = data.size();
+				if (data.size() >= SAMPLE_SIZE) {
+					const auto stride = (data.size() - SAMPLE_SIZE) / (SAMPLES - 1);
+					for (std::size_t i = 0; i < SAMPLES; ++i)
+						result.sample = REX::FNV1A_64(data.subspan(i * stride, SAMPLE_SIZE), result.sample);
+				}
+				return result;
+			}
+
+			// Matches stored next to the plugin as `<plugin>.scancache`: the
+			// header, then per entry its key, record count and records.
+			struct SCAN_CACHE_HEADER
+			{
+				static constexpr std::uint64_t MAGIC{ 0x48434E4143534C43 };  // "CLSCANCH"
+				static constexpr std::uint32_t LAYOUT{ 1 };
+
+				std::uint64_t   magic{ MAGIC };
+				std::uint32_t   layout{ LAYOUT };
+				std::uint32_t   pad{ 0 };
+				MODULE_IDENTITY module;
+				std::uint64_t   count{ 0 };
+				std::uint64_t   size{ 0 };
+				std::uint64_t   checksum{ 0 };
+			};
+
+			class SCAN_CACHE
+			{
+			public:
+				static SCAN_CACHE& get()
+				{
+					static SCAN_CACHE cache;
+					return cache;
+				}
+
+				// Whether get() has run, so flushing never samples `.text`
+				// before the first scan
+				static bool constructed() noexcept { return s_constructed.load(std::memory_order_acquire); }
+
+				SCAN_CACHE(const SCAN_CACHE&) = delete;
+				SCAN_CACHE& operator=(const SCAN_CACHE&) = delete;
+
+				~SCAN_CACHE()
+				{
+					if (m_dirty)
+						write();
+				}
+
+				void flush()
+				{
+					const std::scoped_lock lock(m_lock);
+					if (m_dirty && write())
+						m_dirty = false;
+				}
+
+				std::optional<std::vector<std::uint64_t>> find(const std::uint64_t a_key, const std::function<bool(std::uint64_t)>& a_verify)
+				{
+					const std::scoped_lock lock(m_lock);
+
+					const auto it = m_entries.find(a_key);
+					if (it == m_entries.end())
+						return std::nullopt;
+
+					if (!std::ranges::all_of(it->second, a_verify)) {
+						REX::DEBUG("Scan cache entry {:016X} failed verification, scanning again", a_key);
+						m_entries.erase(it);
+						m_dirty = true;
+						return std::nullopt;
+					}
+
+					return it->second;
+				}
+
+				void store(const std::uint64_t a_key, std::vector<std::uint64_t> a_records)
+				{
+					const std::scoped_lock lock(m_lock);
+
+					// A miss cannot be verified, so it is not worth keeping
+					if (a_records.empty()) {
+						m_dirty |= m_entries.erase(a_key) != 0;
+						return;
+					}
+
+					auto& entry = m_entries[a_key];
+					if (entry != a_records) {
+						entry = std::move(a_records);
+						m_dirty = true;
+					}
+				}
+
+			private:
+				// Runs on the first scan, so `.text` is sampled once, before
+				// this plugin installs hooks based on what the scans found
+				SCAN_CACHE() :
+					m_module(module_identity())
+				{
+					wchar_t buffer[REX::W32::MAX_PATH];
+					REX::W32::GetModuleFileNameW(REX::W32::GetCurrentModule(), buffer, REX::W32::MAX_PATH);
+					m_path = buffer;
+					m_path.replace_extension(L".scancache");
+
+					if (!load()) {
+						m_entries.clear();
+						m_dirty = true;
+					}
+
+					s_constructed.store(true, std::memory_order_release);
+				}
+
+				bool load()
+				{
+					std::ifstream file(m_path, std::ios::in | std::ios::binary);
+					if (!file)
+						return false;
+
+					SCAN_CACHE_HEADER header;
+					if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+						header.magic != SCAN_CACHE_HEADER::MAGIC ||
+						header.layout != SCAN_CACHE_HEADER::LAYOUT ||
+						header.module != m_module ||
+						header.size % sizeof(std::uint64_t) != 0) {
+						REX::DEBUG(L"Scan cache is stale: {}", m_path.wstring());
+						return false;
+					}
+
+					std::vector<std::uint64_t> payload(header.size / sizeof(std::uint64_t));
+					if (!file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(header.size)) ||
+						REX::FNV1A_64(std::as_bytes(std::span{ payload })) != header.checksum) {
+						REX::WARN(L"Scan cache is corrupt: {}", m_path.wstring());
+						return false;
+					}
+
+					std::size_t pos = 0;
+					for (std::uint64_t i = 0; i < header.count; ++i) {
+						if (payload.size() - pos < 2 || payload.size() - pos - 2 < payload[pos + 1])
+							return false;
+
+						const auto key = payload[pos];
+						const auto count = static_cast<std::size_t>(payload[pos + 1]);
+						m_entries[key].assign(payload.begin() + (pos + 2), payload.begin() + (pos + 2 + count));
+						pos += 2 + count;
+					}
+
+					return pos == payload.size();
+				}
+
+				bool write() const
+				{
+					std::vector<std::uint64_t> payload;
+					for (const auto& [key, records] : m_entries) {
+						payload.push_back(key);
+						payload.push_back(records.size());
+						payload.insert(payload.end(), records.begin(), records.end());
+					}
+
+					SCAN_CACHE_HEADER header;
+					header.module = m_module;
+					header.count = m_entries.size();
+					header.size = payload.size() * sizeof(std::uint64_t);
+					header.checksum = REX::FNV1A_64(std::as_bytes(std::span{ payload }));
+
+					// Replaced in one step so the next launch never reads a partial file
+					auto temp = m_path;
+					temp += L".tmp";
+					{
+						std::ofstream file(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+						file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+						file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(header.size));
+						if (!file) {
+							REX::WARN(L"Failed to write scan cache: {}", temp.wstring());
+							std::error_code ec;
+							std::filesystem::remove(temp, ec);
+							return false;
+						}
+					}
+
+					std::error_code ec;
+					std::filesystem::rename(temp, m_path, ec);
+					if (ec) {
+						REX::DEBUG(L"Failed to replace scan cache: {}", m_path.wstring());
+						std::filesystem::remove(temp, ec);
+						return false;
+					}
+
+					return true;
+				}
+
+				static inline std::atomic<bool> s_constructed{ false };
+
+				std::mutex                                                  m_lock;
+				std::filesystem::path                                       m_path;
+				MODULE_IDENTITY                                             m_module;
+				std::unordered_map<std::uint64_t, std::vector<std::uint64_t>> m_entries;
+				bool                                                        m_dirty{ false };
+			};
+		}
+
+		std::uint64_t scan_cache_key(const Segment& a_segment, const std::span<const std::byte> a_bytes, const std::span<const std::byte> a_masks, const std::uint32_t a_search) noexcept
+		{
+			const std::array<std::uint64_t, 3> search{ a_segment.offset(), a_segment.size(), a_search };
+			return REX::FNV1A_64(a_masks, REX::FNV1A_64(a_bytes, REX::FNV1A_64(std::as_bytes(std::span{ search }))));
+		}
+
+		std::optional<std::vector<std::uint64_t>> scan_cache_find(const std::uint64_t a_key, const std::function<bool(std::uint64_t)>& a_verify)
+		{
+			return SCAN_CACHE::get().find(a_key, a_verify);
+		}
+
+		void scan_cache_store(const std::uint64_t a_key, std::vector<std::uint64_t> a_records)
+		{
+			SCAN_CACHE::get().store(a_key, std::move(a_records));
+		}
+#endif
+	}
+
+	void FlushScanCache()
+	{
+#ifdef COMMONLIB_OPTION_SCAN_CACHE
+		if (detail::SCAN_CACHE::constructed())
+			detail::SCAN_CACHE::get().flush();
+#endif
+	}
+
+	std::optional<std::uintptr_t> Scan(const Segment& a_segment, const RuntimePattern& a_pattern)
+	{
+		const auto matches = detail::find_matches(a_segment, a_pattern, false);
+		return matches.empty() ? std::nullopt : std::optional{ matches.front() };
+	}
+
+	std::optional<std::uintptr_t> Scan(const RuntimePattern& a_pattern)
+	{
+		return Scan(detail::ModuleBase::GetSingleton()->segment(Segment::text), a_pattern);
+	}
+
+	std::vector<std::uintptr_t> ScanAll(const Segment& a_segment, const RuntimePattern& a_pattern)
+	{
+		return detail::find_matches(a_segment, a_pattern, true);
+	}
+
+	std::vector<std::uintptr_t> ScanAll(const RuntimePattern& a_pattern)
+	{
+		return ScanAll(detail::ModuleBase::GetSingleton()->segment(Segment::text), a_pattern);
+	}
+
+	std::size_t PatternSet::add(const std::span<const std::byte> a_bytes, const std::span<const std::byte> a_masks)
+	{
+		if (a_bytes.empty() || a_bytes.size() != a_masks.size() || a_bytes.size() > std::numeric_limits<std::uint16_t>::max()) {
+			REX::FAIL("Invalid pattern for PatternSet: {} bytes, {} masks", a_bytes.size(), a_masks.size());
+		}
+
+		const auto index = static_cast<std::uint32_t>(m_patterns.size());
+		const auto length = a_bytes.size();
+		m_patterns.push_back({ m_bytes.size(), length });
+		for (std::size_t i = 0; i < length; ++i) {
+			m_bytes.push_back(a_bytes[i] & a_masks[i]);
+			m_masks.push_back(a_masks[i]);
+		}
+
+		// A pattern without a 2-byte anchor is checked at every position
+		const auto anchor = detail::scan_anchor(a_bytes, a_masks);
+		if (anchor.size != 2) {
+			m_unanchored.push_back(index);
+			return index;
+		}
+
+		// File the pattern under every key its anchor bytes match. Keys are
+		// generated in order, so one merge keeps the entries sorted.
+		const auto lo = std::to_integer<std::uint32_t>(anchor.value[0]);
+		const auto hi = std::to_integer<std::uint32_t>(anchor.value[1]);
+		const auto loMask = std::to_integer<std::uint32_t>(anchor.mask[0]);
+		const auto hiMask = std::to_integer<std::uint32_t>(anchor.mask[1]);
+		const auto middle = static_cast<std::ptrdiff_t>(m_entries.size());
+		for (std::uint32_t key = 0; key < 0x10000; ++key) {
+			if (((key & loMask) != lo) || (((key >> 8) & hiMask) != hi))
+				continue;
+
+			m_entries.push_back({ static_cast<std::uint16_t>(key), static_cast<std::uint16_t>(anchor.offset), index });
+			m_keys[key / 64] |= std::uint64_t{ 1 } << (key % 64);
+		}
+		std::inplace_merge(m_entries.begin(), m_entries.begin() + middle, m_entries.end(), [](auto&& a_lhs, auto&& a_rhs) {
+			return a_lhs.key < a_rhs.key;
+		});
+
+		return index;
+	}
+
+	std::vector<PatternSet::MATCH> PatternSet::scan(const Segment& a_segment) const
+	{
+#ifdef COMMONLIB_OPTION_SCAN_CACHE
+		// Keyed by every pattern and where each one ends, and recorded as
+		// the pattern index above the offset from the module base
+		const auto base = detail::ModuleBase::GetSingleton()->base();
+		const auto key = REX::FNV1A_64(std::as_bytes(std::span{ m_patterns }), detail::scan_cache_key(a_segment, m_bytes, m_masks, 2));
+		const auto cached = detail::scan_cache_find(key, [&](const std::uint64_t a_record) {
+			const auto pattern = static_cast<std::size_t>(a_record >> 32);
+			const auto address = base + (a_record & 0xFFFFFFFF);
+			return pattern < m_patterns.size() &&
+			       address >= a_segment.address() &&
+			       address - a_segment.address() + m_patterns[pattern].length <= a_segment.size() &&
+			       match(m_patterns[pattern], reinterpret_cast<const std::byte*>(address));
+		});
+		if (cached) {
+			std::vector<MATCH> result;
+			for (const auto record : *cached)
+				result.push_back({ static_cast<std::size_t>(record >> 32), base + (record & 0xFFFFFFFF) });
+			return result;
+		}
+
+		auto                       result = sweep(a_segment);
+		std::vector<std::uint64_t> records;
+		for (const auto& match : result)
+			records.push_back(std::uint64_t{ match.pattern } << 32 | (match.address - base));
+		detail::scan_cache_store(key, std::move(records));
+		return result;
+#else
+		return sweep(a_segment);
+#endif
+	}
+
+	std::vector<PatternSet::MATCH> PatternSet::scan() const
+	{
+		return scan(detail::ModuleBase::GetSingleton()->segment(Segment::text));
+	}
+
+	std::vector<PatternSet::MATCH> PatternSet::sweep(const Segment& a_segment) const
+	{
+		const auto first = a_segment.pointer<const std::byte>();
+		const auto size = a_segment.size();
+
+		// Each chunk owns the windows and unanchored starts in a run of
+		// positions, and may read matches past its end
+		const auto                      workers = REX::PARALLEL_WORKERS(size, detail::SCAN_GRAIN);
+		std::vector<std::vector<MATCH>> chunks(workers);
+
+		REX::PARALLEL_FOR(workers, [&](const std::size_t a_worker) {
+			const auto begin = size * a_worker / workers;
+			const auto end = size * (a_worker + 1) / workers;
+			auto&      matches = chunks[a_worker];
+			const auto report = [&](const std::uint32_t a_pattern, const std::size_t a_start) {
+				const auto& pattern = m_patterns[a_pattern];
+				if (a_start + pattern.length <= size && match(pattern, first + a_start))
+					matches.push_back({ a_pattern, reinterpret_cast<std::uintptr_t>(first + a_start) });
+			};
+
+			// Test every 2-byte window against the 8 KB anchor bitmap, which
+			// stays in L1. Only windows that anchor some pattern read a bucket.
+			const auto bytes = reinterpret_cast<const std::uint8_t*>(first);
+			const auto keys = m_keys.data();
+			for (std::size_t pos = begin; pos < end && pos + 1 < size; ++pos) {
+				const auto key = static_cast<std::uint16_t>(bytes[pos] | (bytes[pos + 1] << 8));
+				if (!((keys[key / 64] >> (key % 64)) & 1))
+					continue;
+
+				auto it = std::lower_bound(m_entries.begin(), m_entries.end(), key, [](auto&& a_lhs, auto&& a_rhs) {
+					return a_lhs.key < a_rhs;
+				});
+				for (; it != m_entries.end() && it->key == key; ++it) {
+					if (pos >= it->offset)
+						report(it->pattern, pos - it->offset);
+				}
+			}
+
+			for (const auto pattern : m_unanchored) {
+				for (std::size_t start = begin; start < end; ++start) {
+					report(pattern, start);
+				}
+			}
+		});
+
+		std::vector<MATCH> result;
+		for (const auto& matches : chunks)
+			result.insert(result.end(), matches.begin(), matches.end());
+
+		std::ranges::sort(result, [](auto&& a_lhs, auto&& a_rhs) {
+			return a_lhs.address != a_rhs.address ? a_lhs.address < a_rhs.address : a_lhs.pattern < a_rhs.pattern;
+		});
+		return result;
+	}
+
+	bool PatternSet::match(const PATTERN& a_pattern, const std::byte* a_start) const noexcept
+	{
+		const auto bytes = m_bytes.data() + a_pattern.first;
+		const auto masks = m_masks.data() + a_pattern.first;
+		for (std::size_t i = 0; i < a_pattern.length; ++i) {
+			if ((a_start[i] & masks[i]) != bytes[i])
+				return false;
+		}
+		return true;
+	}
+}
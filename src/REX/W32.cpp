@@ -318,6 +318,7 @@ REX_W32_IMPORT(REX::W32::BOOL, GetComputerNameW, wchar_t*, std::uint32_t*);
 REX_W32_IMPORT(std::uint32_t, GetCurrentDirectoryA, std::uint32_t, char*);
 REX_W32_IMPORT(std::uint32_t, GetCurrentDirectoryW, std::uint32_t, wchar_t*);
 REX_W32_IMPORT(REX::W32::HANDLE, GetCurrentProcess);
+REX_W32_IMPORT(std::uint32_t, GetCurrentProcessId);
 REX_W32_IMPORT(std::uint32_t, GetCurrentThreadId);
 REX_W32_IMPORT(std::uint32_t, GetEnvironmentVariableA, const char*, char*, std::uint32_t);
 REX_W32_IMPORT(std::uint32_t, GetEnvironmentVariableW, const wchar_t*, wchar_t*, std::uint32_t);
@@ -526,6 +527,11 @@ namespace REX::W32
 		return ::W32_IMPL_GetCurrentProcess();
 	}
 
+	std::uint32_t GetCurrentProcessId() noexcept
+	{
+		return ::W32_IMPL_GetCurrentProcessId();
+	}
+
 	std::uint32_t GetCurrentThreadId() noexcept
 	{
 		return ::W32_IMPL_GetCurrentThreadId();
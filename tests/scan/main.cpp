@@ -0,0 +1,118 @@
+// commonlib-scan-test: checks the threaded segment scan of REL::Scan
+// against a single-threaded scan and a byte-by-byte match on random
+// buffers and patterns.
+//
+// Only the standard library and REL/ScanCore.h are used, so the test also
+// builds and runs off Windows.
+
+#include "REL/ScanCore.h"
+
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+	using REL::detail::scan_anchor;
+	using REL::detail::scan_matches;
+	using REL::detail::SCAN_ANCHOR;
+
+	// Small enough that every buffer is split between several threads
+	constexpr std::size_t TEST_GRAIN{ 64 };
+	constexpr std::size_t SINGLE_THREAD{ std::numeric_limits<std::size_t>::max() };
+
+	struct PATTERN
+	{
+		std::vector<std::byte> bytes;
+		std::vector<std::byte> masks;
+
+		[[nodiscard]] bool match(const std::byte* a_start) const noexcept
+		{
+			for (std::size_t i = 0; i < bytes.size(); ++i) {
+				if ((a_start[i] & masks[i]) != bytes[i])
+					return false;
+			}
+			return true;
+		}
+	};
+
+	// Draws bytes from a small alphabet so patterns match often, and
+	// masks that are fixed, wildcard or a single nibble.
+	PATTERN random_pattern(std::mt19937_64& a_rng, const std::size_t a_length)
+	{
+		constexpr std::byte MASKS[]{ std::byte{ 0xFF }, std::byte{ 0xFF }, std::byte{ 0xFF }, std::byte{ 0x00 }, std::byte{ 0xF0 }, std::byte{ 0x0F } };
+
+		PATTERN result;
+		for (std::size_t i = 0; i < a_length; ++i) {
+			const auto mask = MASKS[a_rng() % std::size(MASKS)];
+			result.masks.push_back(mask);
+			result.bytes.push_back(static_cast<std::byte>(a_rng() % 4) & mask);
+		}
+		return result;
+	}
+
+	std::vector<const std::byte*> brute_force(const std::span<const std::byte> a_range, const PATTERN& a_pattern, const bool a_all)
+	{
+		std::vector<const std::byte*> result;
+		for (std::size_t i = 0; i + a_pattern.bytes.size() <= a_range.size(); ++i) {
+			if (a_pattern.match(a_range.data() + i)) {
+				result.push_back(a_range.data() + i);
+				if (!a_all)
+					break;
+			}
+		}
+		return result;
+	}
+
+	bool check(const std::span<const std::byte> a_range, const PATTERN& a_pattern, const SCAN_ANCHOR& a_anchor, const std::size_t a_case)
+	{
+		const auto match = [&](const std::byte* a_start) {
+			return a_pattern.match(a_start);
+		};
+
+		for (const bool all : { true, false }) {
+			const auto expected = brute_force(a_range, a_pattern, all);
+			const auto threaded = scan_matches(a_range, a_pattern.bytes.size(), a_anchor, all, match, TEST_GRAIN);
+			const auto single = scan_matches(a_range, a_pattern.bytes.size(), a_anchor, all, match, SINGLE_THREAD);
+			if (threaded != expected || single != expected) {
+				std::fprintf(
+					stderr,
+					"case %zu (%s): %zu bytes, %zu-byte pattern, anchor %zu+%zu: expected %zu, threaded %zu, single %zu matches\n",
+					a_case, all ? "all" : "first", a_range.size(), a_pattern.bytes.size(), a_anchor.offset, a_anchor.size,
+					expected.size(), threaded.size(), single.size());
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+int main()
+{
+	constexpr std::size_t CASES{ 20000 };
+
+	std::mt19937_64 rng(0);
+	std::size_t     failures = 0;
+	for (std::size_t i = 0; i < CASES; ++i) {
+		std::vector<std::byte> buffer(rng() % 4096 + 1);
+		for (auto& byte : buffer)
+			byte = static_cast<std::byte>(rng() % 4);
+
+		const auto pattern = random_pattern(rng, rng() % 8 + 1);
+
+		// The anchor the scanner would pick, and none at all, which
+		// visits every start
+		failures += !check(buffer, pattern, scan_anchor(pattern.bytes, pattern.masks), i);
+		failures += !check(buffer, pattern, SCAN_ANCHOR{}, i);
+	}
+
+	if (failures) {
+		std::fprintf(stderr, "%zu of %zu cases failed\n", failures, CASES * 2);
+		return 1;
+	}
+
+	std::printf("%zu cases passed\n", CASES * 2);
+	return 0;
+}
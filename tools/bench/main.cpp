@@ -0,0 +1,405 @@
+// commonlib-bench: times the hot paths of REL against the approaches they
+// replaced, on synthetic data shaped like an Address Library database.
+//
+// Only the standard library and the REL headers that avoid Windows are
+// used, so the benchmarks also build and run off Windows. Numbers are the
+// median of several runs; compare them between builds on one machine.
+
+#include "REL/CachedID.h"
+#include "REL/IDDBCodec.h"
+#include "REL/ScanCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	using REL::codec::MAPPING;
+
+	constexpr std::size_t RUNS{ 7 };
+
+	// Median wall time of `a_func` over RUNS runs, in nanoseconds
+	template <class F>
+	double median_ns(F&& a_func)
+	{
+		std::vector<double> times;
+		for (std::size_t i = 0; i < RUNS; ++i) {
+			const auto start = std::chrono::steady_clock::now();
+			a_func();
+			times.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+		}
+
+		std::ranges::sort(times);
+		return times[times.size() / 2];
+	}
+
+	// ID-sorted mappings with the small ID gaps and scattered 16-byte
+	// aligned offsets of a real database
+	std::vector<MAPPING> synthetic_mappings(const std::size_t a_count)
+	{
+		std::mt19937_64      rng(0);
+		std::vector<MAPPING> result(a_count);
+		std::uint64_t        id = 0;
+		for (auto& mapping : result) {
+			id += rng() % 8 == 0 ? rng() % 64 + 2 : 1;
+			mapping = { id, (rng() % 0x400000) * 16 + 0x1000 };
+		}
+		return result;
+	}
+
+	bool same(const std::span<const MAPPING> a_lhs, const std::span<const MAPPING> a_rhs) noexcept
+	{
+		return std::ranges::equal(a_lhs, a_rhs, [](const MAPPING& a_left, const MAPPING& a_right) {
+			return a_left.id == a_right.id && a_left.offset == a_right.offset;
+		});
+	}
+
+	// Reads a stream one field at a time, as IDDB does when a file cannot
+	// be buffered
+	class FIELD_READER
+	{
+	public:
+		explicit FIELD_READER(const std::filesystem::path& a_path) :
+			m_stream(a_path, std::ios::in | std::ios::binary)
+		{
+			m_stream.exceptions(std::ios::badbit | std::ios::failbit | std::ios::eofbit);
+		}
+
+		template <class T>
+		T readout()
+		{
+			T value{};
+			m_stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+			return value;
+		}
+
+	private:
+		std::ifstream m_stream;
+	};
+
+	// Startup cost of decoding a V1/V2 delta stream from disk: per-field
+	// reads against one buffered read and the table-driven decoder.
+	void bench_decode(const std::size_t a_count)
+	{
+		constexpr std::uint64_t POINTER_SIZE{ 8 };
+
+		const auto             mappings = synthetic_mappings(a_count);
+		std::vector<std::byte> stream;
+		MAPPING                prev{ 0, 0 };
+		for (const auto& mapping : mappings) {
+			REL::codec::encode_mapping(stream, prev, mapping, POINTER_SIZE);
+			prev = mapping;
+		}
+
+		const auto path = std::filesystem::temp_directory_path() / "commonlib-bench-decode.bin";
+		{
+			std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+			out.write(reinterpret_cast<const char*>(stream.data()), static_cast<std::streamsize>(stream.size()));
+		}
+
+		std::vector<MAPPING> out(a_count);
+		bool                 valid = true;
+
+		const auto fields = median_ns([&]() {
+			FIELD_READER reader(path);
+			valid &= REL::codec::decode_fields(reader, POINTER_SIZE, out) == REL::codec::DECODE::Ordered;
+		});
+		valid &= same(out, mappings);
+
+		const auto buffered = median_ns([&]() {
+			std::ifstream          in(path, std::ios::in | std::ios::binary);
+			const auto             size = static_cast<std::size_t>(std::filesystem::file_size(path));
+			std::vector<std::byte> buffer(size + REL::codec::DELTA_PADDING);
+			in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size));
+			valid &= REL::codec::decode_buffer({ buffer.data(), size }, POINTER_SIZE, out) == REL::codec::DECODE::Ordered;
+		});
+		valid &= same(out, mappings);
+
+		std::error_code ec;
+		std::filesystem::remove(path, ec);
+
+		std::printf("decode: %zu entries, %zu bytes%s\n", a_count, stream.size(), valid ? "" : " (MISMATCH)");
+		std::printf("  per-field reads:     %8.2f ms\n", fields / 1e6);
+		std::printf("  buffered table:      %8.2f ms\n", buffered / 1e6);
+	}
+
+	// Sorted mappings seen through the interface INDEX builds from
+	struct MAPPING_TABLE
+	{
+		std::span<const MAPPING> mappings;
+
+		[[nodiscard]] bool          empty() const noexcept { return mappings.empty(); }
+		[[nodiscard]] std::size_t   size() const noexcept { return mappings.size(); }
+		[[nodiscard]] std::uint64_t id(std::size_t a_pos) const noexcept { return mappings[a_pos].id; }
+		[[nodiscard]] std::uint64_t offset(std::size_t a_pos) const noexcept { return mappings[a_pos].offset; }
+	};
+
+	// Single ID lookups: binary search over the sorted mappings against the
+	// B-tree index IDDB builds over the same table.
+	void bench_lookup(const std::size_t a_count)
+	{
+		constexpr std::size_t QUERIES{ 1 << 20 };
+
+		const auto mappings = synthetic_mappings(a_count);
+
+		REL::codec::INDEX index;
+		index.build(MAPPING_TABLE{ mappings });
+
+		std::mt19937_64            rng(1);
+		std::vector<std::uint64_t> queries(QUERIES);
+		for (auto& query : queries)
+			query = mappings[rng() % mappings.size()].id;
+
+		std::uint64_t expected = 0;
+		const auto binary = median_ns([&]() {
+			std::uint64_t sum = 0;
+			for (const auto query : queries)
+				sum += std::ranges::lower_bound(mappings, query, {}, &MAPPING::id)->offset;
+			expected = sum;
+		});
+
+		std::uint64_t actual = 0;
+		const auto btree = median_ns([&]() {
+			std::uint64_t sum = 0;
+			for (const auto query : queries)
+				sum += index.offset(index.lower_bound(query));
+			actual = sum;
+		});
+
+		std::printf("lookup: %zu entries, %zu queries%s\n", a_count, QUERIES, expected == actual ? "" : " (MISMATCH)");
+		std::printf("  std::lower_bound:    %8.2f ns/lookup\n", binary / QUERIES);
+		std::printf("  B-tree index:        %8.2f ns/lookup\n", btree / QUERIES);
+	}
+
+	// Stand-ins for the module and database singletons behind ID::address()
+	struct BENCH_MODULE
+	{
+		static BENCH_MODULE* GetSingleton()
+		{
+			static BENCH_MODULE singleton;
+			return &singleton;
+		}
+
+		[[nodiscard]] std::uintptr_t base() const noexcept { return 0x140000000; }
+	};
+
+	struct BENCH_DATABASE
+	{
+		static BENCH_DATABASE* GetSingleton()
+		{
+			static BENCH_DATABASE singleton;
+			return &singleton;
+		}
+
+		[[nodiscard]] std::uint64_t offset(const std::uint64_t a_id) const noexcept
+		{
+			return index.offset(index.lower_bound(a_id));
+		}
+
+		REL::codec::INDEX index;
+	};
+
+	// Resolves like REL::ID: both singletons and an index search per call
+	class BENCH_ID
+	{
+	public:
+		explicit constexpr BENCH_ID(const std::uint64_t a_id) noexcept :
+			m_id(a_id)
+		{}
+
+		[[nodiscard]] std::uintptr_t address() const
+		{
+			return BENCH_MODULE::GetSingleton()->base() + BENCH_DATABASE::GetSingleton()->offset(m_id);
+		}
+
+		[[nodiscard]] constexpr std::uint64_t id() const noexcept { return m_id; }
+
+	private:
+		std::uint64_t m_id;
+	};
+
+	// Repeated resolution of a small set of hot IDs, as a hook or per-frame
+	// call site does: ID::address() every time against CachedID.
+	void bench_cachedid(const std::size_t a_count)
+	{
+		constexpr std::size_t HOT{ 64 };
+		constexpr std::size_t READS{ 1 << 20 };
+
+		const auto mappings = synthetic_mappings(a_count);
+		BENCH_DATABASE::GetSingleton()->index.build(MAPPING_TABLE{ mappings });
+
+		std::mt19937_64       rng(2);
+		std::vector<BENCH_ID> ids;
+		for (std::size_t i = 0; i < HOT; ++i)
+			ids.emplace_back(mappings[rng() % mappings.size()].id);
+
+		std::vector<REL::detail::CachedIDImpl<BENCH_ID>> cached(ids.begin(), ids.end());
+
+		std::uint64_t expected = 0;
+		const auto uncached = median_ns([&]() {
+			std::uint64_t sum = 0;
+			for (std::size_t i = 0; i < READS; ++i)
+				sum += ids[i % HOT].address();
+			expected = sum;
+		});
+
+		std::uint64_t actual = 0;
+		const auto hits = median_ns([&]() {
+			std::uint64_t sum = 0;
+			for (std::size_t i = 0; i < READS; ++i)
+				sum += cached[i % HOT].address();
+			actual = sum;
+		});
+
+		std::printf("cachedid: %zu entries, %zu IDs, %zu reads%s\n", a_count, HOT, READS, expected == actual ? "" : " (MISMATCH)");
+		std::printf("  ID::address():       %8.2f ns/read\n", uncached / READS);
+		std::printf("  CachedID:            %8.2f ns/read\n", hits / READS);
+	}
+
+	// Every start in `a_range` where the masked pattern matches, testing
+	// each byte of each start as a plain pattern search does
+	std::vector<const std::byte*> naive_matches(const std::span<const std::byte> a_range, const std::span<const std::byte> a_bytes, const std::span<const std::byte> a_masks)
+	{
+		std::vector<const std::byte*> result;
+		for (std::size_t i = 0; i + a_bytes.size() <= a_range.size(); ++i) {
+			std::size_t j = 0;
+			while (j < a_bytes.size() && (a_range[i + j] & a_masks[j]) == (a_bytes[j] & a_masks[j]))
+				++j;
+			if (j == a_bytes.size())
+				result.push_back(a_range.data() + i);
+		}
+		return result;
+	}
+
+	// Pattern scans over a code-like segment: byte-by-byte matching against
+	// the anchored SIMD scan, on one thread and split between threads.
+	void bench_scan()
+	{
+		constexpr std::size_t SIZE{ 64 << 20 };
+		constexpr std::size_t PLANTED{ 16 };
+
+		// Mostly common opcode and ModRM bytes, skewed towards the front
+		// of the list, with some noise
+		std::mt19937_64        rng(3);
+		std::vector<std::byte> segment(SIZE);
+		for (auto& byte : segment) {
+			const auto common = REL::detail::COMMON_BYTES.size();
+			byte = rng() % 8 == 0 ? static_cast<std::byte>(rng()) : static_cast<std::byte>(REL::detail::COMMON_BYTES[rng() % (rng() % common + 1)]);
+		}
+
+		// mov rax, [rip+disp32]; ret
+		constexpr std::array<std::byte, 8> bytes{ std::byte{ 0x48 }, std::byte{ 0x8B }, std::byte{ 0x05 }, {}, {}, {}, {}, std::byte{ 0xC3 } };
+		constexpr std::array<std::byte, 8> masks{ std::byte{ 0xFF }, std::byte{ 0xFF }, std::byte{ 0xFF }, {}, {}, {}, {}, std::byte{ 0xFF } };
+		for (std::size_t i = 0; i < PLANTED; ++i) {
+			const auto pos = rng() % (SIZE - bytes.size());
+			for (std::size_t j = 0; j < bytes.size(); ++j) {
+				if (masks[j] == std::byte{ 0xFF })
+					segment[pos + j] = bytes[j];
+			}
+		}
+
+		const auto anchor = REL::detail::scan_anchor(bytes, masks);
+		const auto match = [&](const std::byte* a_start) {
+			for (std::size_t j = 0; j < bytes.size(); ++j) {
+				if ((a_start[j] & masks[j]) != bytes[j])
+					return false;
+			}
+			return true;
+		};
+
+		std::vector<const std::byte*> expected;
+		const auto naive = median_ns([&]() {
+			expected = naive_matches(segment, bytes, masks);
+		});
+
+		std::vector<const std::byte*> single;
+		const auto anchored = median_ns([&]() {
+			single = REL::detail::scan_matches(segment, bytes.size(), anchor, true, match, SIZE);
+		});
+
+		std::vector<const std::byte*> threaded;
+		const auto parallel = median_ns([&]() {
+			threaded = REL::detail::scan_matches(segment, bytes.size(), anchor, true, match);
+		});
+
+		const auto valid = single == expected && threaded == expected;
+		std::printf("scan: %zu MiB, %zu matches%s\n", SIZE >> 20, expected.size(), valid ? "" : " (MISMATCH)");
+		std::printf("  byte-by-byte:        %8.2f ms\n", naive / 1e6);
+		std::printf("  anchor, 1 thread:    %8.2f ms\n", anchored / 1e6);
+		std::printf("  anchor, %2zu threads:  %8.2f ms\n", REX::PARALLEL_WORKERS(SIZE, REL::detail::SCAN_GRAIN), parallel / 1e6);
+	}
+
+	void usage()
+	{
+		std::fprintf(
+			stderr,
+			"usage:\n"
+			"  commonlib-bench [decode|lookup|cachedid|scan|all] [--entries <count>]\n"
+			"\n"
+			"decode    V1/V2 stream decoding from disk, per-field against buffered\n"
+			"lookup    single ID lookups, binary search against the B-tree index\n"
+			"cachedid  repeated reads of hot IDs, ID::address() against CachedID\n"
+			"scan      pattern scan of a 64 MiB segment, byte-by-byte against anchored\n"
+			"\n"
+			"--entries sets the size of the synthetic database, 500000 by default.\n");
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	std::string_view which = "all";
+	std::size_t      entries = 500000;
+	for (int i = 1; i < a_argc; ++i) {
+		const std::string_view arg = a_argv[i];
+		if (arg == "--entries" && i + 1 < a_argc) {
+			entries = std::strtoull(a_argv[++i], nullptr, 10);
+		} else if (!arg.starts_with("-")) {
+			which = arg;
+		} else {
+			usage();
+			return 2;
+		}
+	}
+
+	if (entries == 0) {
+		usage();
+		return 2;
+	}
+
+	bool ran = false;
+	if (which == "decode" || which == "all") {
+		bench_decode(entries);
+		ran = true;
+	}
+
+	if (which == "lookup" || which == "all") {
+		bench_lookup(entries);
+		ran = true;
+	}
+
+	if (which == "cachedid" || which == "all") {
+		bench_cachedid(entries);
+		ran = true;
+	}
+
+	if (which == "scan" || which == "all") {
+		bench_scan();
+		ran = true;
+	}
+
+	if (!ran) {
+		usage();
+		return 2;
+	}
+
+	return 0;
+}
@@ -0,0 +1,722 @@
+// commonlib-iddb-tool: converts Address Library databases between the CSV,
+// delta-encoded V1/V2 and dense V5 formats, and reports their statistics.
+//
+// Only the standard library and REL/IDDBCodec.h are used, so the tool also
+// builds and runs off Windows.
+
+#include "REL/IDDBCodec.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	using REL::codec::MAPPING;
+
+	enum class Format
+	{
+		CSV,
+		V2,
+		V5
+	};
+
+	struct DATABASE
+	{
+		Format                       format{ Format::V2 };
+		std::array<std::uint32_t, 4> version{};
+		std::string                  name;
+		std::uint32_t                pointerSize{ 8 };
+		std::vector<MAPPING>         mappings;  // sorted by ID, unique
+	};
+
+	struct OPTIONS
+	{
+		std::optional<Format>                       to;
+		std::optional<std::array<std::uint32_t, 4>> version;
+		std::optional<std::string>                  name;
+	};
+
+	[[noreturn]] void fail(const std::string& a_message)
+	{
+		throw std::runtime_error(a_message);
+	}
+
+	const char* format_name(const Format a_format) noexcept
+	{
+		switch (a_format) {
+			case Format::CSV:
+				return "csv";
+			case Format::V2:
+				return "v2";
+			case Format::V5:
+				return "v5";
+		}
+		return "?";
+	}
+
+	std::optional<Format> parse_format(const std::string_view a_str) noexcept
+	{
+		if (a_str == "csv")
+			return Format::CSV;
+		if (a_str == "v2")
+			return Format::V2;
+		if (a_str == "v5")
+			return Format::V5;
+		return std::nullopt;
+	}
+
+	// Accepts `a.b.c.d`, `a-b-c-d` or `a_b_c_d`, missing parts are zero.
+	std::optional<std::array<std::uint32_t, 4>> parse_version(std::string_view a_str) noexcept
+	{
+		std::array<std::uint32_t, 4> version{};
+		for (std::size_t i = 0; i < version.size() && !a_str.empty(); ++i) {
+			const auto [ptr, ec] = std::from_chars(a_str.data(), a_str.data() + a_str.size(), version[i]);
+			if (ec != std::errc{})
+				return std::nullopt;
+
+			a_str.remove_prefix(static_cast<std::size_t>(ptr - a_str.data()));
+			if (!a_str.empty()) {
+				if (a_str[0] != '.' && a_str[0] != '-' && a_str[0] != '_')
+					return std::nullopt;
+				a_str.remove_prefix(1);
+			}
+		}
+
+		return a_str.empty() ? std::optional{ version } : std::nullopt;
+	}
+
+	std::string version_string(const std::array<std::uint32_t, 4>& a_version)
+	{
+		return std::to_string(a_version[0]) + '.' + std::to_string(a_version[1]) + '.' + std::to_string(a_version[2]) + '.' + std::to_string(a_version[3]);
+	}
+
+	std::vector<std::byte> read_file(const std::filesystem::path& a_path)
+	{
+		std::ifstream in(a_path, std::ios::binary);
+		if (!in)
+			fail("cannot open " + a_path.string());
+
+		std::vector<std::byte> data(static_cast<std::size_t>(std::filesystem::file_size(a_path)));
+		in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!in)
+			fail("cannot read " + a_path.string());
+
+		return data;
+	}
+
+	void write_file(const std::filesystem::path& a_path, const std::vector<std::byte>& a_data)
+	{
+		std::ofstream out(a_path, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(a_data.data()), static_cast<std::streamsize>(a_data.size()));
+		if (!out)
+			fail("cannot write " + a_path.string());
+	}
+
+	class READER
+	{
+	public:
+		READER(const std::vector<std::byte>& a_data, const std::size_t a_pos = 0) noexcept :
+			m_data(a_data),
+			m_pos(a_pos)
+		{}
+
+		template <class T>
+		T read()
+		{
+			T value;
+			bytes(&value, sizeof(value));
+			return value;
+		}
+
+		void bytes(void* a_dst, const std::size_t a_size)
+		{
+			if (m_data.size() - m_pos < a_size)
+				fail("unexpected end of file");
+
+			std::memcpy(a_dst, m_data.data() + m_pos, a_size);
+			m_pos += a_size;
+		}
+
+		[[nodiscard]] std::size_t pos() const noexcept { return m_pos; }
+
+	private:
+		const std::vector<std::byte>& m_data;
+		std::size_t                   m_pos;
+	};
+
+	template <class T>
+	void append(std::vector<std::byte>& a_out, const T& a_value)
+	{
+		const auto bytes = reinterpret_cast<const std::byte*>(&a_value);
+		a_out.insert(a_out.end(), bytes, bytes + sizeof(a_value));
+	}
+
+	// Sorts by ID and keeps the last value of duplicated IDs, like IDDB does
+	// for CSV files. Returns the number of dropped duplicates.
+	std::size_t normalize(std::vector<MAPPING>& a_mappings)
+	{
+		std::stable_sort(a_mappings.begin(), a_mappings.end(), [](const MAPPING& a_lhs, const MAPPING& a_rhs) {
+			return a_lhs.id < a_rhs.id;
+		});
+
+		std::size_t unique = 0;
+		for (std::size_t i = 0; i < a_mappings.size(); ++i) {
+			if (i + 1 < a_mappings.size() && a_mappings[i].id == a_mappings[i + 1].id)
+				continue;
+			a_mappings[unique++] = a_mappings[i];
+		}
+
+		const auto dropped = a_mappings.size() - unique;
+		a_mappings.resize(unique);
+		return dropped;
+	}
+
+	void load_v2(const std::vector<std::byte>& a_data, DATABASE& a_db)
+	{
+		READER in(a_data, sizeof(std::uint32_t));
+		for (auto& part : a_db.version)
+			part = in.read<std::uint32_t>();
+
+		const auto nameLen = in.read<std::uint32_t>();
+		if (nameLen >= 64)
+			fail("invalid module name length");
+		a_db.name.resize(nameLen);
+		in.bytes(a_db.name.data(), nameLen);
+
+		const auto pointerSize = in.read<std::int32_t>();
+		const auto count = in.read<std::int32_t>();
+		if (pointerSize <= 0 || count < 0)
+			fail("invalid header");
+		a_db.pointerSize = static_cast<std::uint32_t>(pointerSize);
+
+		// The decoder may load up to DELTA_PADDING bytes past the last entry
+		std::vector<std::byte> stream(a_data.begin() + static_cast<std::ptrdiff_t>(in.pos()), a_data.end());
+		const auto             last = stream.size();
+		stream.resize(stream.size() + REL::codec::DELTA_PADDING);
+
+		a_db.mappings.resize(static_cast<std::size_t>(count));
+		switch (REL::codec::decode_buffer({ stream.data(), last }, a_db.pointerSize, a_db.mappings)) {
+			case REL::codec::DECODE::BadType:
+				fail("unhandled delta type");
+			case REL::codec::DECODE::Truncated:
+				fail("unexpected end of file");
+			default:
+				break;
+		}
+
+		if (const auto dropped = normalize(a_db.mappings))
+			std::fprintf(stderr, "warning: %zu duplicate IDs, keeping the last value\n", dropped);
+	}
+
+	void load_v5(const std::vector<std::byte>& a_data, DATABASE& a_db)
+	{
+		READER in(a_data, sizeof(std::int32_t));
+		for (auto& part : a_db.version)
+			part = in.read<std::uint32_t>();
+
+		char name[64]{};
+		in.bytes(name, sizeof(name));
+		a_db.name.assign(name, strnlen(name, sizeof(name)));
+
+		const auto pointerSize = in.read<std::int32_t>();
+		in.read<std::int32_t>();  // data format
+		const auto count = in.read<std::int32_t>();
+		if (pointerSize <= 0 || count < 0)
+			fail("invalid header");
+		a_db.pointerSize = static_cast<std::uint32_t>(pointerSize);
+
+		// A zero offset marks an ID that is not present
+		for (std::uint64_t id = 0; id < static_cast<std::uint64_t>(count); ++id) {
+			if (const auto offset = in.read<std::uint32_t>())
+				a_db.mappings.push_back({ id, offset });
+		}
+	}
+
+	void load_csv(const std::vector<std::byte>& a_data, DATABASE& a_db)
+	{
+		std::string_view text{ reinterpret_cast<const char*>(a_data.data()), a_data.size() };
+		std::size_t      lineNumber = 0;
+
+		// Header line, then the `count,version` metadata line
+		if (!text.empty()) {
+			REL::codec::next_line(text);
+			lineNumber++;
+		}
+		if (!text.empty()) {
+			const auto line = REL::codec::next_line(text);
+			lineNumber++;
+			const auto commaPos = line.find(',');
+			if (commaPos != std::string_view::npos) {
+				if (const auto version = parse_version(REL::codec::trim(line.substr(commaPos + 1))))
+					a_db.version = *version;
+			}
+		}
+
+		REL::codec::CSV_CHUNK chunk;
+		REL::codec::parse_csv_chunk(text, chunk);
+		for (const auto& diag : chunk.diags) {
+			const auto line = std::string(diag.text);
+			std::fprintf(stderr, "warning: line %zu: skipped '%s'\n", lineNumber + 1 + diag.line, line.c_str());
+		}
+
+		a_db.mappings = std::move(chunk.mappings);
+		if (const auto dropped = normalize(a_db.mappings))
+			std::fprintf(stderr, "warning: %zu duplicate IDs, keeping the last value\n", dropped);
+	}
+
+	DATABASE load(const std::filesystem::path& a_path)
+	{
+		const auto data = read_file(a_path);
+
+		DATABASE db;
+		if (a_path.extension() == ".csv") {
+			db.format = Format::CSV;
+			load_csv(data, db);
+			return db;
+		}
+
+		if (data.size() < sizeof(std::uint32_t))
+			fail("unexpected end of file");
+
+		std::uint32_t format;
+		std::memcpy(&format, data.data(), sizeof(format));
+		if (format == 1 || format == 2) {
+			db.format = Format::V2;
+			load_v2(data, db);
+		} else if (format == 5) {
+			db.format = Format::V5;
+			load_v5(data, db);
+		} else {
+			fail("unsupported Address Library format: " + std::to_string(format));
+		}
+
+		return db;
+	}
+
+	std::vector<std::byte> encode_stream(const DATABASE& a_db)
+	{
+		std::vector<std::byte> out;
+		out.reserve(a_db.mappings.size() * 3);
+
+		MAPPING prev{ 0, 0 };
+		for (const auto& mapping : a_db.mappings) {
+			REL::codec::encode_mapping(out, prev, mapping, a_db.pointerSize);
+			prev = mapping;
+		}
+
+		return out;
+	}
+
+	std::vector<std::byte> encode_v2(const DATABASE& a_db)
+	{
+		if (a_db.name.size() >= 64)
+			fail("module name is longer than 63 characters");
+
+		std::vector<std::byte> out;
+		append(out, std::uint32_t{ 2 });
+		for (const auto part : a_db.version)
+			append(out, part);
+		append(out, static_cast<std::uint32_t>(a_db.name.size()));
+		out.insert(out.end(), reinterpret_cast<const std::byte*>(a_db.name.data()), reinterpret_cast<const std::byte*>(a_db.name.data() + a_db.name.size()));
+		append(out, static_cast<std::int32_t>(a_db.pointerSize));
+		append(out, static_cast<std::int32_t>(a_db.mappings.size()));
+
+		const auto stream = encode_stream(a_db);
+		out.insert(out.end(), stream.begin(), stream.end());
+		return out;
+	}
+
+	std::vector<std::byte> encode_v5(const DATABASE& a_db)
+	{
+		if (a_db.name.size() >= 64)
+			fail("module name is longer than 63 characters");
+		if (a_db.version == std::array<std::uint32_t, 4>{})
+			fail("V5 needs a game version, pass --version");
+
+		const auto count = a_db.mappings.empty() ? 0 : a_db.mappings.back().id + 1;
+		if (count > 0x7FFFFFFF)
+			fail("IDs are too large for a dense V5 table");
+
+		std::vector<std::uint32_t> offsets(static_cast<std::size_t>(count));
+		for (const auto& mapping : a_db.mappings) {
+			if (mapping.offset > 0xFFFFFFFF)
+				fail("offset of ID " + std::to_string(mapping.id) + " does not fit in 32 bits");
+			offsets[static_cast<std::size_t>(mapping.id)] = static_cast<std::uint32_t>(mapping.offset);
+		}
+
+		char name[64]{};
+		std::memcpy(name, a_db.name.data(), a_db.name.size());
+
+		std::vector<std::byte> out;
+		out.reserve(96 + offsets.size() * sizeof(std::uint32_t));
+		append(out, std::int32_t{ 5 });
+		for (const auto part : a_db.version)
+			append(out, part);
+		append(out, name);
+		append(out, static_cast<std::int32_t>(a_db.pointerSize));
+		append(out, std::int32_t{ 0 });
+		append(out, static_cast<std::int32_t>(offsets.size()));
+		out.insert(out.end(), reinterpret_cast<const std::byte*>(offsets.data()), reinterpret_cast<const std::byte*>(offsets.data() + offsets.size()));
+		return out;
+	}
+
+	std::vector<std::byte> encode_csv(const DATABASE& a_db)
+	{
+		std::string out = "id,offset\n";
+		out += std::to_string(a_db.mappings.size()) + ',' + version_string(a_db.version) + '\n';
+
+		char line[64];
+		for (const auto& mapping : a_db.mappings) {
+			const auto len = std::snprintf(line, sizeof(line), "%llu,0x%llX\n", static_cast<unsigned long long>(mapping.id), static_cast<unsigned long long>(mapping.offset));
+			out.append(line, static_cast<std::size_t>(len));
+		}
+
+		const auto bytes = reinterpret_cast<const std::byte*>(out.data());
+		return { bytes, bytes + out.size() };
+	}
+
+	// The mappings a database keeps once stored in `a_format`: V5 cannot
+	// tell a zero offset from a missing ID.
+	std::vector<MAPPING> representable(const std::vector<MAPPING>& a_mappings, const Format a_format)
+	{
+		std::vector<MAPPING> result;
+		result.reserve(a_mappings.size());
+		for (const auto& mapping : a_mappings) {
+			if (a_format != Format::V5 || mapping.offset != 0)
+				result.push_back(mapping);
+		}
+		return result;
+	}
+
+	bool compare(const std::vector<MAPPING>& a_lhs, const std::vector<MAPPING>& a_rhs)
+	{
+		const auto count = std::min(a_lhs.size(), a_rhs.size());
+		for (std::size_t i = 0; i < count; ++i) {
+			if (a_lhs[i].id != a_rhs[i].id || a_lhs[i].offset != a_rhs[i].offset) {
+				std::fprintf(
+					stderr, "mismatch at entry %zu: %llu -> 0x%llX vs %llu -> 0x%llX\n", i,
+					static_cast<unsigned long long>(a_lhs[i].id), static_cast<unsigned long long>(a_lhs[i].offset),
+					static_cast<unsigned long long>(a_rhs[i].id), static_cast<unsigned long long>(a_rhs[i].offset));
+				return false;
+			}
+		}
+
+		if (a_lhs.size() != a_rhs.size()) {
+			std::fprintf(stderr, "mismatch: %zu vs %zu entries\n", a_lhs.size(), a_rhs.size());
+			return false;
+		}
+
+		return true;
+	}
+
+	int convert(const std::filesystem::path& a_in, const std::filesystem::path& a_out, const OPTIONS& a_options)
+	{
+		auto db = load(a_in);
+		if (a_options.version)
+			db.version = *a_options.version;
+		if (a_options.name)
+			db.name = *a_options.name;
+
+		auto to = a_out.extension() == ".csv" ? Format::CSV : Format::V5;
+		if (a_options.to)
+			to = *a_options.to;
+		if (to == Format::V5) {
+			const auto zero = db.mappings.size() - representable(db.mappings, to).size();
+			if (zero)
+				std::fprintf(stderr, "warning: V5 cannot store %zu IDs with a zero offset, dropping them\n", zero);
+		}
+
+		std::vector<std::byte> data;
+		switch (to) {
+			case Format::CSV:
+				data = encode_csv(db);
+				break;
+			case Format::V2:
+				data = encode_v2(db);
+				break;
+			case Format::V5:
+				data = encode_v5(db);
+				break;
+		}
+		write_file(a_out, data);
+
+		// Read the output back and check it holds what was written
+		const auto written = load(a_out);
+		if (!compare(representable(db.mappings, to), written.mappings) || (to != Format::CSV && written.version != db.version)) {
+			std::fprintf(stderr, "error: %s does not read back as written\n", a_out.string().c_str());
+			return 1;
+		}
+
+		std::printf(
+			"%s (%s) -> %s (%s): %zu entries, %llu -> %zu bytes, verified\n",
+			a_in.string().c_str(), format_name(db.format), a_out.string().c_str(), format_name(to),
+			written.mappings.size(), static_cast<unsigned long long>(std::filesystem::file_size(a_in)), data.size());
+		return 0;
+	}
+
+	int verify(const std::filesystem::path& a_lhs, const std::filesystem::path& a_rhs)
+	{
+		const auto lhs = load(a_lhs);
+		const auto rhs = load(a_rhs);
+
+		// Compare what both formats can represent
+		const auto format = lhs.format == Format::V5 || rhs.format == Format::V5 ? Format::V5 : Format::V2;
+		if (!compare(representable(lhs.mappings, format), representable(rhs.mappings, format)))
+			return 1;
+
+		std::printf("%s and %s match: %zu entries\n", a_lhs.string().c_str(), a_rhs.string().c_str(), representable(lhs.mappings, format).size());
+		return 0;
+	}
+
+	template <class F>
+	double time_ns(F&& a_func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		a_func();
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	int stats(const std::filesystem::path& a_path)
+	{
+		DATABASE   db;
+		const auto loadTime = time_ns([&]() { db = load(a_path); });
+
+		const auto& mappings = db.mappings;
+		const auto  count = mappings.size();
+		const auto  minID = count ? mappings.front().id : 0;
+		const auto  maxID = count ? mappings.back().id : 0;
+		const auto  v2Size = 4 + 16 + 4 + db.name.size() + 8 + encode_stream(db).size();
+		const auto  v5Size = 96 + (count ? maxID + 1 : 0) * sizeof(std::uint32_t);
+
+		std::printf("file:         %s\n", a_path.string().c_str());
+		std::printf("format:       %s\n", format_name(db.format));
+		std::printf("version:      %s\n", version_string(db.version).c_str());
+		std::printf("name:         %s\n", db.name.c_str());
+		std::printf("entries:      %zu\n", count);
+		std::printf("id range:     %llu..%llu\n", static_cast<unsigned long long>(minID), static_cast<unsigned long long>(maxID));
+		std::printf("density:      %.1f%%\n", count ? 100.0 * static_cast<double>(count) / static_cast<double>(maxID + 1) : 0.0);
+		std::printf("file size:    %llu bytes\n", static_cast<unsigned long long>(std::filesystem::file_size(a_path)));
+		std::printf("as v2:        %zu bytes (%.2f per entry)\n", v2Size, count ? static_cast<double>(v2Size) / static_cast<double>(count) : 0.0);
+		std::printf("as v5:        %llu bytes\n", static_cast<unsigned long long>(v5Size));
+		std::printf("load:         %.2f ms\n", loadTime / 1e6);
+
+		if (count == 0 || maxID >= 0x7FFFFFFF)
+			return 0;
+
+		// Resolve random present IDs through a binary search over the sorted
+		// pairs and through a dense V5-style array
+		constexpr std::size_t      LOOKUPS = 1 << 22;
+		std::mt19937_64            rng(0);
+		std::vector<std::uint64_t> queries(LOOKUPS);
+		for (auto& query : queries)
+			query = mappings[rng() % count].id;
+
+		std::vector<std::uint32_t> dense(static_cast<std::size_t>(maxID + 1));
+		for (const auto& mapping : mappings)
+			dense[static_cast<std::size_t>(mapping.id)] = static_cast<std::uint32_t>(mapping.offset);
+
+		const auto less = [](const MAPPING& a_mapping, const std::uint64_t a_id) {
+			return a_mapping.id < a_id;
+		};
+
+		volatile std::uint64_t sink = 0;
+
+		const auto search = time_ns([&]() {
+			std::uint64_t sum = 0;
+			for (const auto id : queries)
+				sum += std::lower_bound(mappings.begin(), mappings.end(), id, less)->offset;
+			sink = sum;
+		});
+
+		const auto index = time_ns([&]() {
+			std::uint64_t sum = 0;
+			for (const auto id : queries)
+				sum += dense[static_cast<std::size_t>(id)];
+			sink = sum;
+		});
+
+		std::printf("binary search: %.1f ns/lookup\n", search / LOOKUPS);
+		std::printf("dense array:   %.1f ns/lookup\n", index / LOOKUPS);
+		return 0;
+	}
+
+	// Reads the IDs to bake: an .idmanifest written by IDDB, or text with
+	// one ID per line or separated by commas or spaces, `#` to end of line
+	// being a comment.
+	std::vector<std::uint64_t> load_ids(const std::filesystem::path& a_path)
+	{
+		constexpr std::uint64_t MANIFEST_MAGIC{ 0x464F525044494C43 };  // "CLIDPROF"
+		constexpr std::size_t   MANIFEST_HEADER{ 48 };
+
+		const auto                 data = read_file(a_path);
+		std::vector<std::uint64_t> ids;
+
+		std::uint64_t magic = 0;
+		if (data.size() >= MANIFEST_HEADER && (std::memcpy(&magic, data.data(), sizeof(magic)), magic == MANIFEST_MAGIC)) {
+			std::uint64_t id = 0;
+			for (std::size_t pos = MANIFEST_HEADER; pos < data.size();) {
+				std::uint64_t delta = 0;
+				for (std::uint32_t shift = 0; pos < data.size() && shift < 64; shift += 7) {
+					const auto byte = static_cast<std::uint64_t>(data[pos++]);
+					delta |= (byte & 0x7F) << shift;
+					if (!(byte & 0x80))
+						break;
+				}
+				ids.push_back(id += delta);
+			}
+			return ids;
+		}
+
+		std::string_view text{ reinterpret_cast<const char*>(data.data()), data.size() };
+		while (!text.empty()) {
+			auto line = REL::codec::next_line(text);
+			line = line.substr(0, line.find('#'));
+			while (!line.empty()) {
+				const auto end = line.find_first_of(", \t\r");
+				const auto token = REL::codec::trim(line.substr(0, end));
+				line.remove_prefix(end != std::string_view::npos ? end + 1 : line.size());
+				if (token.empty())
+					continue;
+
+				std::uint64_t id = 0;
+				if (REL::codec::parse_integer(token, id, true) != std::errc{})
+					fail("invalid ID '" + std::string(token) + "'");
+				ids.push_back(id);
+			}
+		}
+
+		return ids;
+	}
+
+	// Writes a header for REL_AOT_OFFSETS resolving the given IDs to the
+	// offsets they have in `a_database`.
+	int header(const std::filesystem::path& a_database, const std::filesystem::path& a_ids, const std::filesystem::path& a_out, const OPTIONS& a_options)
+	{
+		auto db = load(a_database);
+		if (a_options.version)
+			db.version = *a_options.version;
+		if (db.version == std::array<std::uint32_t, 4>{})
+			fail("the database has no game version, pass --version");
+
+		auto ids = load_ids(a_ids);
+		std::ranges::sort(ids);
+		ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+		std::string cases;
+		std::size_t baked = 0;
+		for (const auto id : ids) {
+			const auto it = std::lower_bound(db.mappings.begin(), db.mappings.end(), id, [](const MAPPING& a_mapping, const std::uint64_t a_id) {
+				return a_mapping.id < a_id;
+			});
+			if (it == db.mappings.end() || it->id != id || it->offset == 0) {
+				std::fprintf(stderr, "warning: ID %llu is not in the database, it will be resolved at runtime\n", static_cast<unsigned long long>(id));
+				continue;
+			}
+
+			char line[96];
+			const auto len = std::snprintf(line, sizeof(line), "\t\t\tcase %llu:\n\t\t\t\treturn 0x%llX;\n", static_cast<unsigned long long>(id), static_cast<unsigned long long>(it->offset));
+			cases.append(line, static_cast<std::size_t>(len));
+			++baked;
+		}
+
+		const auto  version = db.version;
+		std::string out;
+		out += "#pragma once\n\n";
+		out += "// Generated by commonlib-iddb-tool from " + a_database.filename().string() + ", do not edit.\n";
+		out += "// Included by REL/ID.h when REL_AOT_OFFSETS names this file.\n\n";
+		out += "#include <array>\n#include <cstdint>\n\n";
+		out += "namespace REL::aot\n{\n";
+		out += "\tinline constexpr std::array<std::uint16_t, 4> VERSION{ " + std::to_string(version[0]) + ", " + std::to_string(version[1]) + ", " + std::to_string(version[2]) + ", " + std::to_string(version[3]) + " };\n\n";
+		out += "\t// Offset of an ID in that version, or zero if it was not baked\n";
+		out += "\t[[nodiscard]] constexpr std::uint64_t offset(const std::uint64_t a_id) noexcept\n\t{\n";
+		out += "\t\tswitch (a_id) {\n" + cases + "\t\t\tdefault:\n\t\t\t\treturn 0;\n\t\t}\n\t}\n}\n";
+
+		const auto bytes = reinterpret_cast<const std::byte*>(out.data());
+		write_file(a_out, { bytes, bytes + out.size() });
+
+		std::printf("%s: %zu of %zu IDs baked for %s\n", a_out.string().c_str(), baked, ids.size(), version_string(version).c_str());
+		return 0;
+	}
+
+	void usage()
+	{
+		std::fprintf(
+			stderr,
+			"usage:\n"
+			"  commonlib-iddb-tool convert <in> <out> [--to csv|v2|v5] [--version a.b.c.d] [--name <module>]\n"
+			"  commonlib-iddb-tool verify <a> <b>\n"
+			"  commonlib-iddb-tool stats <file>\n"
+			"  commonlib-iddb-tool header <database> <ids> <out.h> [--version a.b.c.d]\n"
+			"\n"
+			"Inputs ending in .csv are read as CSV, others by their format word.\n"
+			"convert writes V5 unless the output ends in .csv or --to is given,\n"
+			"and reads the result back to verify it.\n"
+			"header bakes the offsets of the IDs listed in <ids>, a text file or an\n"
+			".idmanifest, into a header for REL_AOT_OFFSETS.\n");
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	const std::vector<std::string_view> args(a_argv + 1, a_argv + a_argc);
+	if (args.empty()) {
+		usage();
+		return 2;
+	}
+
+	try {
+		const auto first = args[0] == "convert" ? 3 : 4;
+		if ((args[0] == "convert" || args[0] == "header") && args.size() >= static_cast<std::size_t>(first)) {
+			OPTIONS options;
+			for (std::size_t i = first; i < args.size(); ++i) {
+				const auto value = i + 1 < args.size() ? args[i + 1] : std::string_view{};
+				if (args[i] == "--to" && (options.to = parse_format(value))) {
+					++i;
+				} else if (args[i] == "--version" && (options.version = parse_version(value))) {
+					++i;
+				} else if (args[i] == "--name" && !value.empty()) {
+					options.name = std::string(value);
+					++i;
+				} else {
+					usage();
+					return 2;
+				}
+			}
+			if (args[0] == "header") {
+				if (options.to || options.name) {
+					usage();
+					return 2;
+				}
+				return header(args[1], args[2], args[3], options);
+			}
+
+			return convert(args[1], args[2], options);
+		}
+
+		if (args[0] == "verify" && args.size() == 3)
+			return verify(args[1], args[2]);
+
+		if (args[0] == "stats" && args.size() == 2)
+			return stats(args[1]);
+
+	} catch (const std::exception& e) {
+		std::fprintf(stderr, "error: %s\n", e.what());
+		return 1;
+	}
+
+	usage();
+	return 2;
+}
@@ -33,6 +33,42 @@ option("commonlib_xbyak", function()
     set_description("enable xbyak support for Trampoline")
 end)
 
+option("commonlib_iddb_cache", function()
+    set_default(false)
+    set_description("enable the on-disk cache of decoded Address Library databases")
+end)
+
+option("commonlib_iddb_lazy", function()
+    set_default(false)
+    set_description("enable on-demand block decoding of V1/V2 Address Library databases")
+end)
+
+option("commonlib_iddb_stats", function()
+    set_default(false)
+    set_description("enable Address Library load timings and lookup counters")
+end)
+
+option("commonlib_iddb_manifest", function()
+    set_default(false)
+    set_description("enable pre-resolving the Address Library IDs used in the previous session")
+end)
+
+option("commonlib_scan_cache", function()
+    set_default(false)
+    set_description("enable the on-disk cache of signature scan results")
+end)
+
+option("commonlib_iddb_legacy_layout", function()
+    set_default(false)
+    set_description("share decoded Address Library databases in the 16-byte per entry layout")
+end)
+
+option("commonlib_aot_offsets", function()
+    set_default("")
+    set_showmenu(true)
+    set_description("header of offsets baked by commonlib-iddb-tool for REL_AOT_OFFSETS")
+end)
+
 -- add packages
 add_requires("spdlog v1.16.0", { configs = { header_only = false, wchar = true, std_format = true } })
 
@@ -73,8 +109,38 @@ target("commonlib-shared", function()
         add_defines("COMMONLIB_OPTION_XBYAK=1", { public = true })
     end
 
+    if has_config("commonlib_iddb_cache") then
+        add_defines("COMMONLIB_OPTION_IDDB_CACHE=1", { public = true })
+    end
+
+    if has_config("commonlib_iddb_lazy") then
+        add_defines("COMMONLIB_OPTION_IDDB_LAZY=1", { public = true })
+    end
+
+    if has_config("commonlib_iddb_stats") then
+        add_defines("COMMONLIB_OPTION_IDDB_STATS=1", { public = true })
+    end
+
+    if has_config("commonlib_iddb_manifest") then
+        add_defines("COMMONLIB_OPTION_IDDB_MANIFEST=1", { public = true })
+    end
+
+    if has_config("commonlib_scan_cache") then
+        add_defines("COMMONLIB_OPTION_SCAN_CACHE=1", { public = true })
+    end
+
+    if has_config("commonlib_iddb_legacy_layout") then
+        add_defines("COMMONLIB_OPTION_IDDB_LEGACY_LAYOUT=1", { public = true })
+    end
+
+    local aot_offsets = get_config("commonlib_aot_offsets")
+    if aot_offsets and aot_offsets ~= "" then
+        local header = path.absolute(aot_offsets, os.projectdir()):gsub("\\", "/")
+        add_defines(format("REL_AOT_OFFSETS=\"%s\"", header), { public = true })
+    end
+
     -- add options
-    add_options("commonlib_ini", "commonlib_json", "commonlib_toml", "commonlib_xbyak", { public = true })
+    add_options("commonlib_ini", "commonlib_json", "commonlib_toml", "commonlib_xbyak", "commonlib_iddb_cache", "commonlib_iddb_lazy", "commonlib_iddb_stats", "commonlib_iddb_manifest", "commonlib_scan_cache", "commonlib_iddb_legacy_layout", "commonlib_aot_offsets", { public = true })
 
     -- add system links
     add_syslinks("advapi32", "bcrypt", "d3d11", "d3dcompiler", "dbghelp", "dxgi", "ole32", "shell32", "user32", "version", "ws2_32")
@@ -145,3 +211,48 @@ target("commonlib-shared", function()
         { public = true }
     )
 end)
+
+target("commonlib-iddb-tool", function()
+    -- set target kind
+    set_kind("binary")
+
+    -- set build by default
+    set_default(false)
+
+    -- add source files
+    add_files("tools/iddb/main.cpp")
+
+    -- add header files
+    add_includedirs("include")
+end)
+
+target("commonlib-bench", function()
+    -- set target kind
+    set_kind("binary")
+
+    -- set build by default
+    set_default(false)
+
+    -- add source files
+    add_files("tools/bench/main.cpp")
+
+    -- add header files
+    add_includedirs("include")
+end)
+
+target("commonlib-scan-test", function()
+    -- set target kind
+    set_kind("binary")
+
+    -- set build by default
+    set_default(false)
+
+    -- add source files
+    add_files("tests/scan/main.cpp")
+
+    -- add header files
+    add_includedirs("include")
+
+    -- add tests
+    add_tests("default")
+end)